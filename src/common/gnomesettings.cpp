@@ -29,13 +29,17 @@
 #endif
 
 // QtCore
+#include <QCache>
 #include <QDir>
+#include <QFileSystemWatcher>
 #include <QLoggingCategory>
 #include <QSettings>
 #include <QStandardPaths>
 #include <QString>
+#include <QThreadPool>
 #include <QTimer>
 #include <QVariant>
+#include <QVector>
 
 // QtDbus
 #include <QDBusConnection>
@@ -49,15 +53,29 @@
 // QtGui
 #include <QApplication>
 #include <QFont>
-#include <QMainWindow>
 #include <QPalette>
-#include <QToolBar>
+#include <QStyle>
+#include <QStyleFactory>
+#include <QWindow>
+
+#include <qpa/qwindowsysteminterface.h>
 
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
 
+// Delay after startup or a style switch before we prepare the style for the opposite appearance
+#define STANDBY_STYLE_DELAY 2000
+// Delay after startup before we prepare the backend to fall back to when the portal goes away
+#define STANDBY_PROVIDER_DELAY 2000
+// Number of accent color palettes we keep around for switching back and forth
+#define ACCENT_PALETTE_CACHE_SIZE 8
+// Size of the small font relative to the system font, same as Pango's "small" scale
+#define SMALL_FONT_SCALE 0.8333
+// Delay for coalescing changes of the Kvantum theme before we write it into the user's config
+#define KVANTUM_CONFIG_DELAY 1000
+
 Q_GLOBAL_STATIC(GnomeSettings, gnomeSettingsGlobal)
 Q_LOGGING_CATEGORY(QGnomePlatform, "qt.qpa.qgnomeplatform")
 
@@ -66,6 +84,14 @@ static inline bool checkSandboxApplication()
     return !QStandardPaths::locate(QStandardPaths::RuntimeLocation, QStringLiteral("flatpak-info")).isEmpty() || qEnvironmentVariableIsSet("SNAP");
 }
 
+static void writeKvantumConfig(const QString &theme)
+{
+    QSettings config(QDir::homePath() + "/.config/Kvantum/kvantum.kvconfig", QSettings::NativeFormat);
+    if (!config.contains("theme") || config.value("theme").toString() != theme) {
+        config.setValue("theme", theme);
+    }
+}
+
 GnomeSettings &GnomeSettings::getInstance()
 {
     return *gnomeSettingsGlobal;
@@ -73,12 +99,31 @@ GnomeSettings &GnomeSettings::getInstance()
 
 GnomeSettings::GnomeSettings(QObject *parent)
     : QObject(parent)
-    , m_fallbackFont(new QFont(QLatin1String("Sans"), 10))
     , m_isRunningInSandbox(checkSandboxApplication())
     , m_canUseFileChooserPortal(!m_isRunningInSandbox)
 {
     gtk_init(nullptr, nullptr);
 
+    m_iconThemePathsWatcher = new QFileSystemWatcher(this);
+    connect(m_iconThemePathsWatcher, &QFileSystemWatcher::directoryChanged, this, &GnomeSettings::onIconThemeDirectoryChanged);
+
+    m_kvantumWatcher = new QFileSystemWatcher(this);
+    connect(m_kvantumWatcher, &QFileSystemWatcher::directoryChanged, this, &GnomeSettings::onKvantumDirectoryChanged);
+
+    m_kvantumConfigWriter = new QThreadPool(this);
+    m_kvantumConfigWriter->setMaxThreadCount(1);
+    m_kvantumConfigTimer = new QTimer(this);
+    m_kvantumConfigTimer->setSingleShot(true);
+    m_kvantumConfigTimer->setInterval(KVANTUM_CONFIG_DELAY);
+    connect(m_kvantumConfigTimer, &QTimer::timeout, this, [this]() {
+        const QString theme = m_kvantumConfigTheme;
+        m_kvantumConfigWriter->start([theme]() {
+            writeKvantumConfig(theme);
+        });
+    });
+    // Don't lose a pending write when the application quits before the timer fires
+    connect(qApp, &QCoreApplication::aboutToQuit, this, &GnomeSettings::flushKvantumConfig);
+
     if (m_isRunningInSandbox) {
         qCDebug(QGnomePlatform) << "Using xdg-desktop-portal backend";
         m_hintProvider = std::make_unique<PortalHintProvider>(this);
@@ -93,6 +138,13 @@ GnomeSettings::GnomeSettings(QObject *parent)
         if (dbusServiceExists) {
             qCDebug(QGnomePlatform) << "Using xdg-desktop-portal backend";
             m_hintProvider = std::make_unique<PortalHintProvider>(this);
+
+            // Keep GSettings backend ready in case the portal goes away
+            QTimer::singleShot(STANDBY_PROVIDER_DELAY, this, [this]() {
+                if (!m_standbyHintProvider && qobject_cast<PortalHintProvider *>(m_hintProvider.get())) {
+                    m_standbyHintProvider = std::make_unique<GSettingsHintProvider>(this);
+                }
+            });
         } else {
             qCDebug(QGnomePlatform) << "Using GSettings backend";
             m_hintProvider = std::make_unique<GSettingsHintProvider>(this);
@@ -107,21 +159,43 @@ GnomeSettings::GnomeSettings(QObject *parent)
             Q_UNUSED(service)
 
             if (newOwner.isEmpty()) {
+                if (!qobject_cast<PortalHintProvider *>(m_hintProvider.get())) {
+                    return;
+                }
+
                 qCDebug(QGnomePlatform) << "Portal service disappeared. Switching to GSettings backend";
-                m_hintProvider = std::make_unique<GSettingsHintProvider>(this);
-                onHintProviderChanged();
+                if (!m_standbyHintProvider) {
+                    m_standbyHintProvider = std::make_unique<GSettingsHintProvider>(this);
+                }
+                switchHintProvider();
             } else if (oldOwner.isEmpty()) {
                 qCDebug(QGnomePlatform) << "Portal service appeared. Switching xdg-desktop-portal backend";
-                PortalHintProvider *provider = new PortalHintProvider(this, true);
-                connect(provider, &PortalHintProvider::settingsRecieved, this, [=]() {
-                    m_hintProvider.reset(provider);
-                    onHintProviderChanged();
-                });
+                // Settings might have changed while the portal was gone, switch once they are read again
+                PortalHintProvider *provider = qobject_cast<PortalHintProvider *>(m_standbyHintProvider.get());
+                if (provider) {
+                    provider->reload(true);
+                } else {
+                    provider = new PortalHintProvider(this, true);
+                    m_standbyHintProvider.reset(provider);
+                }
+                connect(provider, &PortalHintProvider::settingsRecieved, this, &GnomeSettings::onPortalSettingsReceived, Qt::UniqueConnection);
             }
         });
     }
 
+    // GTK default font, used until we get fonts from the hint provider
+    const QFont defaultFont(QLatin1String("Sans"), 10);
+    for (QPlatformTheme::Font type : {QPlatformTheme::SystemFont,
+                                      QPlatformTheme::FixedFont,
+                                      QPlatformTheme::TitleBarFont,
+                                      QPlatformTheme::MenuFont,
+                                      QPlatformTheme::ToolTipFont,
+                                      QPlatformTheme::SmallFont}) {
+        m_fonts.emplace(type, defaultFont);
+    }
+
     initializeHintProvider();
+    loadFonts();
 
     // Initialize some cursor env variables needed by QtWayland
     onCursorSizeChanged();
@@ -129,6 +203,9 @@ GnomeSettings::GnomeSettings(QObject *parent)
 
     loadPalette();
 
+    m_standbyStyleScheduled = true;
+    QTimer::singleShot(STANDBY_STYLE_DELAY, this, &GnomeSettings::prepareStandbyStyle);
+
     if (m_canUseFileChooserPortal) {
         QTimer::singleShot(0, this, [this]() {
             const QString filePath = QStringLiteral("/proc/%1/root").arg(QCoreApplication::applicationPid());
@@ -170,8 +247,8 @@ GnomeSettings::GnomeSettings(QObject *parent)
 
 GnomeSettings::~GnomeSettings()
 {
-    delete m_fallbackFont;
-    delete m_palette;
+    // Applications which never ran the event loop don't emit aboutToQuit
+    flushKvantumConfig();
 }
 
 void GnomeSettings::initializeHintProvider() const
@@ -185,25 +262,117 @@ void GnomeSettings::initializeHintProvider() const
     connect(m_hintProvider.get(), &HintProvider::themeChanged, this, &GnomeSettings::loadPalette);
     connect(m_hintProvider.get(), &HintProvider::themeChanged, this, &GnomeSettings::themeChanged);
     connect(m_hintProvider.get(), &HintProvider::themeChanged, this, &GnomeSettings::onThemeChanged);
+
+    m_hintProvider->setInterests(interests());
 }
 
-QFont *GnomeSettings::font(QPlatformTheme::Font type) const
+void GnomeSettings::registerInterest(SettingsInterest interest)
 {
-    auto fonts = m_hintProvider->fonts();
+    if (m_interestRefs[interest]++ == 0) {
+        m_hintProvider->setInterests(interests());
+    }
+}
 
-    if (fonts.contains(type)) {
-        return fonts[type];
-    } else if (fonts.contains(QPlatformTheme::SystemFont)) {
-        return fonts[QPlatformTheme::SystemFont];
-    } else {
-        // GTK default font
-        return m_fallbackFont;
+void GnomeSettings::unregisterInterest(SettingsInterest interest)
+{
+    if (--m_interestRefs[interest] == 0) {
+        m_hintProvider->setInterests(interests());
+    }
+}
+
+GnomeSettings::SettingsInterests GnomeSettings::interests() const
+{
+    SettingsInterests interests;
+    for (auto it = m_interestRefs.constBegin(); it != m_interestRefs.constEnd(); ++it) {
+        if (it.value() > 0) {
+            interests |= it.key();
+        }
     }
+    return interests;
 }
 
-QPalette *GnomeSettings::palette() const
+const QFont *GnomeSettings::font(QPlatformTheme::Font type) const
 {
-    return m_palette;
+    switch (type) {
+    case QPlatformTheme::FixedFont:
+    case QPlatformTheme::TitleBarFont:
+    case QPlatformTheme::ToolTipFont:
+        return &m_fonts.at(type);
+    case QPlatformTheme::MenuFont:
+    case QPlatformTheme::MenuBarFont:
+    case QPlatformTheme::MenuItemFont:
+        return &m_fonts.at(QPlatformTheme::MenuFont);
+    case QPlatformTheme::SmallFont:
+    case QPlatformTheme::MiniFont:
+        return &m_fonts.at(QPlatformTheme::SmallFont);
+    default:
+        return &m_fonts.at(QPlatformTheme::SystemFont);
+    }
+}
+
+bool GnomeSettings::updateFont(QPlatformTheme::Font type, const QFont &font)
+{
+    QFont &currentFont = m_fonts.at(type);
+    if (currentFont == font) {
+        return false;
+    }
+
+    // Update in place, pointers we handed out must remain valid
+    currentFont = font;
+    return true;
+}
+
+bool GnomeSettings::loadFonts(bool *titlebarFontChanged)
+{
+    const QHash<QPlatformTheme::Font, QFont> fonts = m_hintProvider->fonts();
+    if (!fonts.contains(QPlatformTheme::SystemFont)) {
+        return false;
+    }
+
+    const QFont::StyleStrategy styleStrategy = m_hintProvider->fontStyleStrategy();
+    const QFont::HintingPreference hintingPreference = m_hintProvider->fontHintingPreference();
+    const auto renderedFont = [styleStrategy, hintingPreference](QFont font) {
+        font.setStyleStrategy(styleStrategy);
+        font.setHintingPreference(hintingPreference);
+        return font;
+    };
+
+    const QFont systemFont = renderedFont(fonts.value(QPlatformTheme::SystemFont));
+    QFont smallFont = systemFont;
+    if (systemFont.pointSizeF() > 0) {
+        smallFont.setPointSizeF(systemFont.pointSizeF() * SMALL_FONT_SCALE);
+    }
+
+    bool changed = updateFont(QPlatformTheme::SystemFont, systemFont);
+    changed |= updateFont(QPlatformTheme::FixedFont, renderedFont(fonts.value(QPlatformTheme::FixedFont, systemFont)));
+    changed |= updateFont(QPlatformTheme::MenuFont, systemFont);
+    changed |= updateFont(QPlatformTheme::ToolTipFont, systemFont);
+    changed |= updateFont(QPlatformTheme::SmallFont, smallFont);
+
+    const bool titlebarChanged = updateFont(QPlatformTheme::TitleBarFont, renderedFont(fonts.value(QPlatformTheme::TitleBarFont, systemFont)));
+    if (titlebarFontChanged) {
+        *titlebarFontChanged = titlebarChanged;
+    }
+
+    return changed;
+}
+
+const QPalette *GnomeSettings::palette(QPlatformTheme::Palette type) const
+{
+    switch (type) {
+    case QPlatformTheme::SystemPalette:
+        return &m_palette;
+    case QPlatformTheme::ToolTipPalette:
+        return &m_toolTipPalette;
+    default:
+        // Qt falls back to the system palette
+        return nullptr;
+    }
+}
+
+Adwaita::ColorVariant GnomeSettings::colorVariant() const
+{
+    return m_paletteVariant;
 }
 
 bool GnomeSettings::canUseFileChooserPortal() const
@@ -227,7 +396,7 @@ bool GnomeSettings::useGtkThemeDarkVariant() const
 bool GnomeSettings::useGtkThemeHighContrastVariant() const
 {
     const QString theme = m_hintProvider->gtkTheme();
-    return theme.toLower().startsWith("highcontrast");
+    return theme.toLower().startsWith("highcontrast") || m_hintProvider->highContrast();
 }
 
 QString GnomeSettings::gtkTheme() const
@@ -256,50 +425,156 @@ GnomeSettings::TitlebarButtonsPlacement GnomeSettings::titlebarButtonPlacement()
     return m_hintProvider->titlebarButtonPlacement();
 }
 
-static QString colorScheme(bool useHighContrast, bool useDarkVariant)
+static int variantIndex(Adwaita::ColorVariant variant)
 {
-    QString colorScheme;
-    if (useHighContrast) {
-        colorScheme = useDarkVariant ? QStringLiteral("AdwaitaHighcontrastInverse") : QStringLiteral("AdwaitaHighcontrast");
-    } else {
-        colorScheme = useDarkVariant ? QStringLiteral("AdwaitaDark") : QStringLiteral("Adwaita");
+    switch (variant) {
+    case Adwaita::ColorVariant::AdwaitaDark:
+        return 1;
+    case Adwaita::ColorVariant::AdwaitaHighcontrast:
+        return 2;
+    case Adwaita::ColorVariant::AdwaitaHighcontrastInverse:
+        return 3;
+    default:
+        return 0;
+    }
+}
+
+static QString colorSchemePath(Adwaita::ColorVariant variant)
+{
+    static const char *const colorSchemes[] = {"Adwaita", "AdwaitaDark", "AdwaitaHighcontrast", "AdwaitaHighcontrastInverse"};
+    // Color schemes don't come and go while we are running, look each of them up just once
+    static QString paths[4];
+    static bool resolved[4] = {};
+
+    const int index = variantIndex(variant);
+    if (!resolved[index]) {
+        paths[index] = QStandardPaths::locate(QStandardPaths::GenericDataLocation,
+                                              QStringLiteral("color-schemes/") + QLatin1String(colorSchemes[index]) + QStringLiteral(".colors"));
+        resolved[index] = true;
     }
 
-    return QStandardPaths::locate(QStandardPaths::GenericDataLocation, QStringLiteral("color-schemes/") + colorScheme + QStringLiteral(".colors"));
+    return paths[index];
 }
 
-void GnomeSettings::loadPalette()
+static void applyAccentColor(QPalette &palette, const QColor &accentColor, bool darkVariant)
 {
-    if (useGtkThemeHighContrastVariant()) {
-        m_palette = new QPalette(Adwaita::Colors::palette(useGtkThemeDarkVariant() ? Adwaita::ColorVariant::AdwaitaHighcontrastInverse
-                                                                                   : Adwaita::ColorVariant::AdwaitaHighcontrast));
-    } else {
-        m_palette = new QPalette(Adwaita::Colors::palette(useGtkThemeDarkVariant() ? Adwaita::ColorVariant::AdwaitaDark : Adwaita::ColorVariant::Adwaita));
+    // Adwaita uses the highlight color also for focus frames
+    const QColor linkColor = darkVariant ? accentColor.lighter(130) : accentColor.darker(110);
+    for (QPalette::ColorGroup group : {QPalette::Active, QPalette::Inactive}) {
+        palette.setColor(group, QPalette::Highlight, accentColor);
+        palette.setColor(group, QPalette::Link, linkColor);
+        palette.setColor(group, QPalette::LinkVisited, linkColor.darker(120));
+#if QT_VERSION >= QT_VERSION_CHECK(6, 6, 0)
+        palette.setColor(group, QPalette::Accent, accentColor);
+#endif
     }
+}
 
-    const QString colorSchemePath = colorScheme(useGtkThemeHighContrastVariant(), useGtkThemeDarkVariant());
-    if (colorSchemePath.isEmpty()) {
-        qCWarning(QGnomePlatform) << "Could not find color scheme " << colorSchemePath;
-        return;
+namespace
+{
+// Palettes for one color variant and accent color
+struct VariantPalettes {
+    explicit VariantPalettes(Adwaita::ColorVariant variant)
+        : system(Adwaita::Colors::palette(variant))
+        , toolTip(system)
+    {
+        // Tooltips are painted with the window roles
+        for (QPalette::ColorGroup group : {QPalette::Active, QPalette::Inactive, QPalette::Disabled}) {
+            toolTip.setColor(group, QPalette::Window, system.color(group, QPalette::ToolTipBase));
+            toolTip.setColor(group, QPalette::WindowText, system.color(group, QPalette::ToolTipText));
+        }
+    }
+
+    VariantPalettes(const VariantPalettes &base, Adwaita::ColorVariant variant, const QColor &accentColor)
+        : system(base.system)
+        , toolTip(base.toolTip)
+    {
+        const bool darkVariant = variant == Adwaita::ColorVariant::AdwaitaDark || variant == Adwaita::ColorVariant::AdwaitaHighcontrastInverse;
+        applyAccentColor(system, accentColor, darkVariant);
+        applyAccentColor(toolTip, accentColor, darkVariant);
     }
 
-    qApp->setProperty("KDE_COLOR_SCHEME_PATH", colorSchemePath);
+    QPalette system;
+    QPalette toolTip;
+};
+} // namespace
+
+static const VariantPalettes &variantPalettes(Adwaita::ColorVariant variant)
+{
+    // Plain variant palettes are built at most once per process
+    static std::unique_ptr<VariantPalettes> palettes[4];
+
+    std::unique_ptr<VariantPalettes> &palette = palettes[variantIndex(variant)];
+    if (!palette) {
+        palette = std::make_unique<VariantPalettes>(variant);
+    }
+
+    return *palette;
 }
 
-void GnomeSettings::onCursorBlinkTimeChanged()
+static const VariantPalettes &variantPalettes(Adwaita::ColorVariant variant, const QColor &accentColor)
+{
+    if (!accentColor.isValid()) {
+        return variantPalettes(variant);
+    }
+
+    // Callers keep copies of the palettes they use, evicting them here is fine
+    static QCache<QPair<int, QRgb>, VariantPalettes> accentPalettes(ACCENT_PALETTE_CACHE_SIZE);
+
+    const QPair<int, QRgb> key(variantIndex(variant), accentColor.rgb());
+    VariantPalettes *palettes = accentPalettes.object(key);
+    if (!palettes) {
+        palettes = new VariantPalettes(variantPalettes(variant), variant, accentColor);
+        accentPalettes.insert(key, palettes);
+    }
+
+    return *palettes;
+}
+
+void GnomeSettings::loadPalette()
 {
-    // If we are not a QApplication, means that we are a QGuiApplication, then we do nothing.
-    if (!qobject_cast<QApplication *>(QCoreApplication::instance())) {
+    const bool useDarkVariant = useGtkThemeDarkVariant();
+    const bool useHighContrastVariant = useGtkThemeHighContrastVariant();
+
+    Adwaita::ColorVariant variant;
+    if (useHighContrastVariant) {
+        variant = useDarkVariant ? Adwaita::ColorVariant::AdwaitaHighcontrastInverse : Adwaita::ColorVariant::AdwaitaHighcontrast;
+    } else {
+        variant = useDarkVariant ? Adwaita::ColorVariant::AdwaitaDark : Adwaita::ColorVariant::Adwaita;
+    }
+
+    const QColor accentColor = m_hintProvider->accentColor();
+
+    // Nothing to do when the resolved variant and accent color didn't change
+    if (m_paletteLoaded && m_paletteVariant == variant && m_paletteAccentColor == accentColor) {
         return;
     }
 
-    QWidgetList widgets = QApplication::allWidgets();
-    for (QWidget *widget : widgets) {
-        if (qobject_cast<QToolBar *>(widget) || qobject_cast<QMainWindow *>(widget)) {
-            QEvent event(QEvent::StyleChange);
-            QApplication::sendEvent(widget, &event);
-        }
+    // Let Qt pick up the new palette, unless we are just initializing
+    if (m_paletteLoaded) {
+        scheduleThemeChange();
+    }
+
+    const VariantPalettes &palettes = variantPalettes(variant, accentColor);
+    m_paletteVariant = variant;
+    m_paletteAccentColor = accentColor;
+    m_palette = palettes.system;
+    m_toolTipPalette = palettes.toolTip;
+    m_paletteLoaded = true;
+
+    const QString colorScheme = colorSchemePath(variant);
+    if (colorScheme.isEmpty()) {
+        qCWarning(QGnomePlatform) << "Could not find color scheme for the current color variant";
+        return;
     }
+
+    qApp->setProperty("KDE_COLOR_SCHEME_PATH", colorScheme);
+}
+
+void GnomeSettings::onCursorBlinkTimeChanged()
+{
+    // Cursor flash time is re-read from theme hints
+    scheduleThemeChange();
 }
 
 void GnomeSettings::onCursorSizeChanged()
@@ -318,31 +593,68 @@ void GnomeSettings::onCursorThemeChanged()
 
 void GnomeSettings::onFontChanged()
 {
+    bool titlebarFontChanged = false;
+    const bool applicationFontsChanged = loadFonts(&titlebarFontChanged);
+
+    if (titlebarFontChanged) {
+        Q_EMIT titlebarChanged();
+    }
+
+    if (!applicationFontsChanged) {
+        return;
+    }
+
+    // The theme change only re-reads the application font, widgets get the new one when it's set.
+    // Setting the application font propagates it top-down to all widgets which don't have their
+    // own font, setting it on each widget would break font inheritance
+    const QFont &systemFont = m_fonts.at(QPlatformTheme::SystemFont);
     if (qobject_cast<QApplication *>(QCoreApplication::instance())) {
-        QApplication::setFont(*m_hintProvider->fonts()[QPlatformTheme::SystemFont]);
-        QWidgetList widgets = QApplication::allWidgets();
-        for (QWidget *widget : widgets) {
-            widget->setFont(*m_hintProvider->fonts()[QPlatformTheme::SystemFont]);
-        }
+        QApplication::setFont(systemFont);
     } else {
-        QGuiApplication::setFont(*m_hintProvider->fonts()[QPlatformTheme::SystemFont]);
+        QGuiApplication::setFont(systemFont);
     }
+
+    scheduleThemeChange();
 }
 
 void GnomeSettings::onIconThemeChanged()
 {
-    // If we are not a QApplication, means that we are a QGuiApplication, then we do nothing.
-    if (!qobject_cast<QApplication *>(QCoreApplication::instance())) {
+    // Icon theme name is re-read from theme hints
+    scheduleThemeChange();
+}
+
+void GnomeSettings::scheduleThemeChange()
+{
+    // Coalesce all changes coming from a single settings update (e.g. gtk-theme and color-scheme
+    // changed at once) into one theme change notification
+    if (m_themeChangePending) {
         return;
     }
 
-    QWidgetList widgets = QApplication::allWidgets();
-    for (QWidget *widget : widgets) {
-        if (qobject_cast<QToolBar *>(widget) || qobject_cast<QMainWindow *>(widget)) {
-            QEvent event(QEvent::StyleChange);
-            QApplication::sendEvent(widget, &event);
-        }
+    m_themeChangePending = true;
+    QTimer::singleShot(0, this, &GnomeSettings::notifyThemeChange);
+}
+
+void GnomeSettings::notifyThemeChange()
+{
+    m_themeChangePending = false;
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 5, 0)
+    // Single application wide theme change, Qt updates palette and hints from it and delivers
+    // the event to all windows
+    QWindowSystemInterface::handleThemeChange(nullptr);
+#else
+    // Older Qt only updates application wide state when no window is specified,
+    // let it finish that and then deliver the event to each window once
+    QWindowSystemInterface::handleThemeChange(nullptr);
+    QWindowSystemInterface::flushWindowSystemEvents();
+
+    QEvent event(QEvent::ThemeChange);
+    const QWindowList windows = QGuiApplication::topLevelWindows();
+    for (QWindow *window : windows) {
+        QGuiApplication::sendEvent(window, &event);
     }
+#endif
 }
 
 void GnomeSettings::onThemeChanged()
@@ -352,21 +664,166 @@ void GnomeSettings::onThemeChanged()
         return;
     }
 
-    app->setStyle(styleNames().first());
+    // Kvantum styles of different GTK themes have the same name, the style has to be created
+    // again to load another Kvantum theme
+    const QString styleName = styleNames().first();
+    const bool kvantum = styleName.startsWith(QStringLiteral("kvantum"));
+    if (app->style() && app->style()->objectName().compare(styleName, Qt::CaseInsensitive) == 0
+        && (!kvantum || m_styleKvantumTheme == m_kvantumConfigTheme)) {
+        return;
+    }
+
+    // The current style is kept for switching back, unless it belongs to the application
+    QStyle *previousStyle = app->style();
+    const QString previousKvantumTheme = m_styleKvantumTheme;
+    if (previousStyle && previousStyle->parent() == app) {
+        // QApplication deletes the previous style it owns
+        previousStyle->setParent(nullptr);
+    } else {
+        previousStyle = nullptr;
+    }
+
+    if (isStandbyStyle(styleName)) {
+        qCDebug(QGnomePlatform) << "Switching to pre-created style" << styleName;
+        QStyle *style = m_standbyStyle;
+        m_standbyStyle.clear();
+        m_styleKvantumTheme = m_standbyKvantumTheme;
+        app->setStyle(style);
+    } else {
+        if (kvantum) {
+            flushKvantumConfig();
+            m_styleKvantumTheme = m_kvantumConfigTheme;
+        }
+        app->setStyle(styleName);
+    }
+
+    if (previousStyle) {
+        delete m_standbyStyle;
+        previousStyle->setParent(app);
+        m_standbyStyle = previousStyle;
+        m_standbyKvantumTheme = previousKvantumTheme;
+    }
+
+    // Switching back between light and dark uses the previous style, it's replaced only when
+    // it's not the one for the opposite appearance
+    if (!m_standbyStyleScheduled) {
+        m_standbyStyleScheduled = true;
+        QTimer::singleShot(STANDBY_STYLE_DELAY, this, &GnomeSettings::prepareStandbyStyle);
+    }
+}
+
+bool GnomeSettings::isStandbyStyle(const QString &styleName) const
+{
+    if (!m_standbyStyle || m_standbyStyle->objectName().compare(styleName, Qt::CaseInsensitive) != 0) {
+        return false;
+    }
+
+    // Kvantum loads its theme when it's created
+    return !styleName.startsWith(QStringLiteral("kvantum")) || m_standbyKvantumTheme == m_kvantumConfigTheme;
+}
+
+void GnomeSettings::prepareStandbyStyle()
+{
+    m_standbyStyleScheduled = false;
+
+    QApplication *app = qobject_cast<QApplication *>(QCoreApplication::instance());
+    if (!app || !app->style()) {
+        return;
+    }
+
+    // Creating a style (e.g. Adwaita or Kvantum, which loads its plugin and parses SVG) is
+    // expensive, create the one we would use for the opposite appearance in advance so
+    // switching between light and dark only has to apply it
+    const Appearance oppositeAppearance = m_hintProvider->appearance() == PreferDark ? PreferLight : PreferDark;
+    const QString styleName = styleNames(oppositeAppearance).first();
+
+    if (app->style()->objectName().compare(styleName, Qt::CaseInsensitive) == 0) {
+        // Appearance doesn't affect used style (e.g. QT_STYLE_OVERRIDE is set)
+        delete m_standbyStyle;
+        return;
+    }
+
+    if (isStandbyStyle(styleName)) {
+        return;
+    }
+
+    delete m_standbyStyle;
+    if (styleName.startsWith(QStringLiteral("kvantum"))) {
+        flushKvantumConfig();
+        m_standbyKvantumTheme = m_kvantumConfigTheme;
+    }
+    m_standbyStyle = QStyleFactory::create(styleName);
+    if (m_standbyStyle) {
+        qCDebug(QGnomePlatform) << "Pre-created style" << styleName;
+        // Deleted together with the application when it's never used
+        m_standbyStyle->setParent(app);
+    }
 }
 
-void GnomeSettings::onHintProviderChanged()
+void GnomeSettings::onPortalSettingsReceived()
 {
+    // Portal provider waiting in standby has fresh settings, it can take over now
+    if (qobject_cast<PortalHintProvider *>(m_standbyHintProvider.get())) {
+        switchHintProvider();
+    }
+}
+
+void GnomeSettings::switchHintProvider()
+{
+    // Catch up with changes we were not watching while in standby, this happens silently as
+    // we compare the whole state with the previously active provider below
+    m_standbyHintProvider->setInterests(interests());
+
+    std::swap(m_hintProvider, m_standbyHintProvider);
+
+    // Previous provider stays alive and keeps its settings, so that we can switch back quickly
+    HintProvider *previous = m_standbyHintProvider.get();
+    disconnect(previous, nullptr, this, nullptr);
+    previous->setInterests({});
+
     initializeHintProvider();
+    onHintProviderChanged(previous);
+}
 
-    // Reload some configuration as switching backends we might get different configuration
-    loadPalette();
-    onThemeChanged();
-    // Also notify to update decorations
-    Q_EMIT themeChanged();
+void GnomeSettings::onHintProviderChanged(const HintProvider *previous)
+{
+    // Reload only configuration which differs between the backends
+    if (previous->gtkTheme() != m_hintProvider->gtkTheme() || previous->appearance() != m_hintProvider->appearance()
+        || previous->canRelyOnAppearance() != m_hintProvider->canRelyOnAppearance() || previous->accentColor() != m_hintProvider->accentColor()
+        || previous->highContrast() != m_hintProvider->highContrast()) {
+        loadPalette();
+        onThemeChanged();
+        // Also notify to update decorations
+        Q_EMIT themeChanged();
+    }
+
+    if (previous->titlebarButtons() != m_hintProvider->titlebarButtons() || previous->titlebarButtonPlacement() != m_hintProvider->titlebarButtonPlacement()) {
+        Q_EMIT titlebarChanged();
+    }
+
+    if (previous->cursorSize() != m_hintProvider->cursorSize()) {
+        onCursorSizeChanged();
+    }
+
+    if (previous->cursorTheme() != m_hintProvider->cursorTheme()) {
+        onCursorThemeChanged();
+    }
+
+    // Compares fonts on its own
+    onFontChanged();
+
+    // Icon theme and other hints are re-read from theme hints
+    if (previous->hints() != m_hintProvider->hints()) {
+        scheduleThemeChange();
+    }
 }
 
 QStringList GnomeSettings::styleNames() const
+{
+    return styleNames(m_hintProvider->appearance());
+}
+
+QStringList GnomeSettings::styleNames(Appearance appearance) const
 {
     QStringList styleNames;
 
@@ -378,8 +835,10 @@ QStringList GnomeSettings::styleNames() const
     }
 
     bool isDarkTheme = false;
-    const bool preferDarkTheme = m_hintProvider->appearance() == Appearance::PreferDark;
+    const bool preferDarkTheme = appearance == Appearance::PreferDark;
     const QString gtkTheme = m_hintProvider->gtkTheme();
+    // Same flag the palette is picked by
+    const bool highContrast = useGtkThemeHighContrastVariant();
 
     if (gtkTheme.toLower().contains("-dark") || gtkTheme.toLower().endsWith("inverse")) {
         isDarkTheme = true;
@@ -402,6 +861,12 @@ QStringList GnomeSettings::styleNames() const
                 }
             }
 
+            // The contrast preference turns the palette into a high contrast one, the style has to match it
+            if (highContrast) {
+                const bool darkStyle = theme.toLower() == QStringLiteral("adwaita-dark") || theme.toLower() == QStringLiteral("highcontrastinverse");
+                theme = darkStyle ? QStringLiteral("highcontrastinverse") : QStringLiteral("highcontrast");
+            }
+
             styleNames << theme;
         }
     }
@@ -420,10 +885,16 @@ QStringList GnomeSettings::styleNames() const
         styleNames << QStringLiteral("kvantum");
     }
 
-    // 4) Use light/dark adwaita as fallback
+    // 4) Use light/dark adwaita as fallback, in its high contrast variant when that's what the palette uses
     if (isDarkTheme || preferDarkTheme) {
+        if (highContrast) {
+            styleNames << QStringLiteral("highcontrastinverse");
+        }
         styleNames << QStringLiteral("adwaita-dark");
     } else {
+        if (highContrast) {
+            styleNames << QStringLiteral("highcontrast");
+        }
         styleNames << QStringLiteral("adwaita");
     }
 
@@ -435,7 +906,13 @@ QStringList GnomeSettings::styleNames() const
 
 QStringList GnomeSettings::xdgIconThemePaths() const
 {
+    if (m_iconThemePathsValid) {
+        return m_iconThemePaths;
+    }
+
     QStringList paths;
+    // Icon directories appearing or disappearing show up as changes of their parent directories
+    QStringList watchedDirs = {QDir::homePath()};
 
     const QFileInfo homeIconDir(QDir::homePath() + QStringLiteral("/.icons"));
     if (homeIconDir.isDir()) {
@@ -448,57 +925,172 @@ QStringList GnomeSettings::xdgIconThemePaths() const
         xdgDirString = QStringLiteral("/usr/local/share:/usr/share");
     }
 
-    for (const QString &xdgDir : xdgDirString.split(QLatin1Char(':'))) {
+    for (const QString &xdgDir : xdgDirString.split(QLatin1Char(':'), Qt::SkipEmptyParts)) {
         const QFileInfo xdgIconsDir(xdgDir + QStringLiteral("/icons"));
         if (xdgIconsDir.isDir()) {
             paths << xdgIconsDir.absoluteFilePath();
+            watchedDirs << xdgDir;
+        } else if (QFileInfo(xdgDir).isDir()) {
+            watchedDirs << xdgDir;
         }
     }
 
+    watchedDirs.removeDuplicates();
+
+    const QStringList previouslyWatchedDirs = m_iconThemePathsWatcher->directories();
+    if (previouslyWatchedDirs != watchedDirs) {
+        if (!previouslyWatchedDirs.isEmpty()) {
+            m_iconThemePathsWatcher->removePaths(previouslyWatchedDirs);
+        }
+        m_iconThemePathsWatcher->addPaths(watchedDirs);
+    }
+
+    m_iconThemePaths = paths;
+    m_iconThemePathsValid = true;
     return paths;
 }
 
+void GnomeSettings::onIconThemeDirectoryChanged()
+{
+    const QStringList previousPaths = m_iconThemePaths;
+    m_iconThemePathsValid = false;
+
+    // Most changes in these directories are unrelated to icons
+    if (xdgIconThemePaths() != previousPaths) {
+        qCDebug(QGnomePlatform) << "Icon theme search paths changed to" << m_iconThemePaths;
+        scheduleThemeChange();
+    }
+}
+
 QString GnomeSettings::kvantumThemeForGtkTheme() const
 {
-    if (m_hintProvider->gtkTheme().isEmpty()) {
+    const QString gtkName = m_hintProvider->gtkTheme();
+    if (gtkName.isEmpty()) {
         // No Gtk theme? Then can't match to Kvantum!
         return QString();
     }
 
-    QString gtkName = m_hintProvider->gtkTheme();
-    QStringList dirs = QStandardPaths::standardLocations(QStandardPaths::GenericDataLocation);
+    auto it = m_kvantumThemes.constFind(gtkName);
+    if (it == m_kvantumThemes.constEnd()) {
+        it = m_kvantumThemes.insert(gtkName, findKvantumTheme(gtkName));
+    }
 
-    // Look for a matching KVantum config file in the theme's folder
-    for (const QString &dir : dirs) {
-        if (QFile::exists(QStringLiteral("%1/themes/%2/Kvantum/%3.kvconfig").arg(dir).arg(gtkName).arg(gtkName))) {
-            return gtkName;
-        }
+    return *it;
+}
+
+// Deepest existing directory on the way from a data directory to a file, creating the rest
+// of the path shows up as its change
+static QString existingParentDirectory(const QString &dataDir, const QString &filePath)
+{
+    QString path = QFileInfo(filePath).path();
+    while (path.size() > dataDir.size() && !QFileInfo(path).isDir()) {
+        path = QFileInfo(path).path();
+    }
+
+    return path;
+}
+
+QString GnomeSettings::findKvantumTheme(const QString &gtkTheme) const
+{
+    // Look for a matching Kvantum config file in the theme's folder first
+    QVector<QPair<QString, QString>> candidates;
+    const QStringList dataDirs = QStandardPaths::standardLocations(QStandardPaths::GenericDataLocation);
+    for (const QString &dataDir : dataDirs) {
+        candidates << qMakePair(dataDir, QStringLiteral("%1/themes/%2/Kvantum/%2.kvconfig").arg(dataDir, gtkTheme));
     }
 
     // No config found in theme folder, look for a Kv<Theme> as shipped as part of Kvantum itself
     // (Kvantum ships KvAdapta, KvAmbiance, KvArc, etc.
-    QStringList names{QStringLiteral("Kv") + gtkName};
+    QStringList names{QStringLiteral("Kv") + gtkTheme};
 
     // Convert Ark-Dark to ArcDark to look for KvArcDark
-    if (gtkName.indexOf("-") != -1) {
-        names.append("Kv" + gtkName.replace("-", ""));
+    if (gtkTheme.contains(QLatin1Char('-'))) {
+        names << QStringLiteral("Kv") + QString(gtkTheme).remove(QLatin1Char('-'));
     }
 
-    for (const QString &name : names) {
-        for (const QString &dir : dirs) {
-            if (QFile::exists(QStringLiteral("%1/Kvantum/%2/%3.kvconfig").arg(dir).arg(name).arg(name))) {
-                return name;
-            }
+    for (const QString &name : qAsConst(names)) {
+        for (const QString &dataDir : dataDirs) {
+            candidates << qMakePair(dataDir, QStringLiteral("%1/Kvantum/%2/%2.kvconfig").arg(dataDir, name));
         }
     }
 
-    return QString();
+    // Only configs this theme could use are checked, not all installed themes. Directories where
+    // the ones preferred over the found one would appear are watched
+    QString kvantumTheme;
+    QStringList watchedDirs;
+    for (const auto &candidate : qAsConst(candidates)) {
+        const QString &dataDir = candidate.first;
+        const QString &configPath = candidate.second;
+        if (!QFileInfo(dataDir).isDir()) {
+            continue;
+        }
+
+        watchedDirs << existingParentDirectory(dataDir, configPath);
+        if (QFileInfo::exists(configPath)) {
+            kvantumTheme = QFileInfo(configPath).completeBaseName();
+            break;
+        }
+    }
+
+    const QStringList previouslyWatchedDirs = m_kvantumWatcher->directories();
+    QStringList newDirs;
+    for (const QString &dir : qAsConst(watchedDirs)) {
+        if (!previouslyWatchedDirs.contains(dir) && !newDirs.contains(dir)) {
+            newDirs << dir;
+        }
+    }
+    if (!newDirs.isEmpty()) {
+        m_kvantumWatcher->addPaths(newDirs);
+    }
+
+    qCDebug(QGnomePlatform) << "Found Kvantum theme" << kvantumTheme << "for GTK theme" << gtkTheme;
+    return kvantumTheme;
+}
+
+void GnomeSettings::onKvantumDirectoryChanged()
+{
+    const QString previousTheme = kvantumThemeForGtkTheme();
+
+    m_kvantumThemes.clear();
+    const QStringList watchedDirs = m_kvantumWatcher->directories();
+    if (!watchedDirs.isEmpty()) {
+        m_kvantumWatcher->removePaths(watchedDirs);
+    }
+
+    // Data directories change often for reasons unrelated to themes. When the matching Kvantum
+    // theme appeared or went away, the style is picked again
+    if (kvantumThemeForGtkTheme() != previousTheme) {
+        onThemeChanged();
+    }
 }
 
 void GnomeSettings::configureKvantum(const QString &theme) const
 {
-    QSettings config(QDir::homePath() + "/.config/Kvantum/kvantum.kvconfig", QSettings::NativeFormat);
-    if (!config.contains("theme") || config.value("theme").toString() != theme) {
-        config.setValue("theme", theme);
+    if (m_kvantumConfigTheme == theme) {
+        return;
+    }
+
+    const bool initialConfiguration = m_kvantumConfigTheme.isEmpty();
+    m_kvantumConfigTheme = theme;
+
+    if (initialConfiguration) {
+        // QApplication creates the style right after asking for style names on startup,
+        // Kvantum has to find its theme in the config by then
+        writeKvantumConfig(theme);
+        m_styleKvantumTheme = theme;
+        return;
+    }
+
+    m_kvantumConfigTimer->start();
+}
+
+void GnomeSettings::flushKvantumConfig()
+{
+    // Kvantum reads the config when the style is created, make sure it's up to date
+    m_kvantumConfigWriter->waitForDone();
+
+    if (m_kvantumConfigTimer->isActive()) {
+        m_kvantumConfigTimer->stop();
+        writeKvantumConfig(m_kvantumConfigTheme);
     }
 }
@@ -20,17 +20,32 @@
 #ifndef GNOME_SETTINGS_H
 #define GNOME_SETTINGS_H
 
+#include <QColor>
 #include <QFlags>
+#include <QFont>
+#include <QHash>
+#include <QMap>
 #include <QObject>
+#include <QPalette>
+#include <QPointer>
 #include <QStringList>
 
 #include <qpa/qplatformtheme.h>
 
+#if QT_VERSION >= 0x060000
+#include <AdwaitaQt6/adwaitacolors.h>
+#else
+#include <AdwaitaQt/adwaitacolors.h>
+#endif
+
+#include <map>
 #include <memory>
 
-class QFont;
+class QFileSystemWatcher;
+class QStyle;
 class QVariant;
-class QPalette;
+class QThreadPool;
+class QTimer;
 
 class HintProvider;
 
@@ -42,14 +57,19 @@ public:
     enum TitlebarButtonsPlacement { LeftPlacement = 0, RightPlacement = 1 };
     enum TitlebarButton { CloseButton = 0x1, MinimizeButton = 0x02, MaximizeButton = 0x04 };
     Q_DECLARE_FLAGS(TitlebarButtons, TitlebarButton);
+    // Consumers of settings, providers watch only for changes somebody is interested in. Widget
+    // applications use all application settings, Qt Quick styles only a part of them
+    enum SettingsInterest { ApplicationInterest = 0x01, DecorationInterest = 0x02, QuickInterest = 0x04 };
+    Q_DECLARE_FLAGS(SettingsInterests, SettingsInterest);
 
     explicit GnomeSettings(QObject *parent = nullptr);
     virtual ~GnomeSettings();
 
     static GnomeSettings &getInstance();
 
-    QFont *font(QPlatformTheme::Font type) const;
-    QPalette *palette() const;
+    const QFont *font(QPlatformTheme::Font type) const;
+    const QPalette *palette(QPlatformTheme::Palette type = QPlatformTheme::SystemPalette) const;
+    Adwaita::ColorVariant colorVariant() const;
     QVariant hint(QPlatformTheme::ThemeHint hint) const;
     bool canUseFileChooserPortal() const;
     bool useGtkThemeDarkVariant() const;
@@ -58,6 +78,9 @@ public:
     TitlebarButtons titlebarButtons() const;
     TitlebarButtonsPlacement titlebarButtonPlacement() const;
 
+    void registerInterest(SettingsInterest interest);
+    void unregisterInterest(SettingsInterest interest);
+
 Q_SIGNALS:
     void themeChanged();
     void titlebarChanged();
@@ -72,25 +95,74 @@ private Q_SLOTS:
     void onIconThemeChanged();
     void onThemeChanged();
 
-    void onHintProviderChanged();
+    void onPortalSettingsReceived();
+
+    void notifyThemeChange();
+    void prepareStandbyStyle();
 
 private:
     void configureKvantum(const QString &theme) const;
+    void flushKvantumConfig();
+    bool isStandbyStyle(const QString &styleName) const;
+    QString findKvantumTheme(const QString &gtkTheme) const;
+    void onKvantumDirectoryChanged();
     void initializeHintProvider() const;
+    void switchHintProvider();
+    void onHintProviderChanged(const HintProvider *previous);
     QString kvantumThemeForGtkTheme() const;
     QStringList styleNames() const;
+    QStringList styleNames(Appearance appearance) const;
     QStringList xdgIconThemePaths() const;
-
-    QFont *m_fallbackFont = nullptr;
-    QPalette *m_palette = nullptr;
+    void onIconThemeDirectoryChanged();
+    void scheduleThemeChange();
+    SettingsInterests interests() const;
+    bool loadFonts(bool *titlebarFontChanged = nullptr);
+    bool updateFont(QPlatformTheme::Font type, const QFont &font);
+
+    // Fonts handed out to Qt, they live as long as we do and are updated in place
+    std::map<QPlatformTheme::Font, QFont> m_fonts;
+    // Palettes of the current variant, copies of the cached ones which are implicitly shared
+    QPalette m_palette;
+    QPalette m_toolTipPalette;
+    bool m_paletteLoaded = false;
+    Adwaita::ColorVariant m_paletteVariant = Adwaita::ColorVariant::Adwaita;
+    QColor m_paletteAccentColor;
 
     std::unique_ptr<HintProvider> m_hintProvider;
+    // Provider for the other backend, kept ready for switching when the portal (dis)appears
+    std::unique_ptr<HintProvider> m_standbyHintProvider;
+
+    QMap<SettingsInterest, int> m_interestRefs;
+
+    // Icon theme search paths, computed on first use and whenever their parent directories change
+    mutable QStringList m_iconThemePaths;
+    mutable bool m_iconThemePathsValid = false;
+    QFileSystemWatcher *m_iconThemePathsWatcher = nullptr;
+
+    // Kvantum themes for GTK themes, looked up on first use and whenever directories where their
+    // configs would be change
+    mutable QHash<QString, QString> m_kvantumThemes;
+    QFileSystemWatcher *m_kvantumWatcher = nullptr;
+
+    // Kvantum theme for the user's Kvantum config, written in background after a short delay
+    mutable QString m_kvantumConfigTheme;
+    // Kvantum theme the current style was created with
+    mutable QString m_styleKvantumTheme;
+    QTimer *m_kvantumConfigTimer = nullptr;
+    QThreadPool *m_kvantumConfigWriter = nullptr;
+
+    // Style for the opposite appearance, owned by QApplication
+    QPointer<QStyle> m_standbyStyle;
+    QString m_standbyKvantumTheme;
+    bool m_standbyStyleScheduled = false;
 
     bool m_relyOnAppearance = false;
     bool m_isRunningInSandbox;
     bool m_canUseFileChooserPortal = false;
+    bool m_themeChangePending = false;
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(GnomeSettings::TitlebarButtons)
+Q_DECLARE_OPERATORS_FOR_FLAGS(GnomeSettings::SettingsInterests)
 
 #endif // GNOME_SETTINGS_H
@@ -56,28 +56,6 @@ GSettingsHintProvider::GSettingsHintProvider(QObject *parent)
         return;
     }
 
-    // Watch for changes
-    QStringList watchListDesktopInterface = {"changed::gtk-theme",
-                                             "changed::color-scheme",
-                                             "changed::icon-theme",
-                                             "changed::cursor-blink-time",
-                                             "changed::font-name",
-                                             "changed::monospace-font-name",
-                                             "changed::cursor-size"};
-    for (const QString &watchedProperty : watchListDesktopInterface) {
-        g_signal_connect(m_settings, watchedProperty.toStdString().c_str(), G_CALLBACK(gsettingPropertyChanged), this);
-
-        // Additionally watch Cinnamon configuration
-        if (m_cinnamonSettings) {
-            g_signal_connect(m_cinnamonSettings, watchedProperty.toStdString().c_str(), G_CALLBACK(gsettingPropertyChanged), this);
-        }
-    }
-
-    QStringList watchListWmPreferences = {"changed::titlebar-font", "changed::button-layout"};
-    for (const QString &watchedProperty : watchListWmPreferences) {
-        g_signal_connect(m_gnomeDesktopSettings, watchedProperty.toStdString().c_str(), G_CALLBACK(gsettingPropertyChanged), this);
-    }
-
     m_canRelyOnAppearance = true;
 
     loadCursorBlinkTime();
@@ -92,6 +70,14 @@ GSettingsHintProvider::GSettingsHintProvider(QObject *parent)
 
 GSettingsHintProvider::~GSettingsHintProvider()
 {
+    for (auto it = m_signalHandlers.constBegin(); it != m_signalHandlers.constEnd(); ++it) {
+        g_signal_handler_disconnect(it.key().first, it.value());
+    }
+
+    for (auto it = m_xsettingsHandlers.constBegin(); it != m_xsettingsHandlers.constEnd(); ++it) {
+        g_signal_handler_disconnect(gtk_settings_get_default(), it.value());
+    }
+
     if (m_cinnamonSettings) {
         g_object_unref(m_cinnamonSettings);
     }
@@ -99,6 +85,97 @@ GSettingsHintProvider::~GSettingsHintProvider()
     g_object_unref(m_settings);
 }
 
+void GSettingsHintProvider::setInterests(GnomeSettings::SettingsInterests interests)
+{
+    HintProvider::setInterests(interests);
+
+    // Do not continue on missing GSettings
+    if (!m_settings && !m_cinnamonSettings) {
+        return;
+    }
+
+    const QStringList watchListDesktopInterface = {QStringLiteral("gtk-theme"),
+                                                   QStringLiteral("color-scheme"),
+                                                   QStringLiteral("icon-theme"),
+                                                   QStringLiteral("cursor-blink-time"),
+                                                   QStringLiteral("font-name"),
+                                                   QStringLiteral("monospace-font-name"),
+                                                   QStringLiteral("font-antialiasing"),
+                                                   QStringLiteral("font-hinting"),
+                                                   QStringLiteral("cursor-size")};
+    for (const QString &watchedProperty : watchListDesktopInterface) {
+        watchSettingsProperty(m_settings, watchedProperty);
+
+        // Additionally watch Cinnamon configuration
+        watchSettingsProperty(m_cinnamonSettings, watchedProperty);
+    }
+
+    const QStringList watchListWmPreferences = {QStringLiteral("titlebar-font"), QStringLiteral("button-layout")};
+    for (const QString &watchedProperty : watchListWmPreferences) {
+        watchSettingsProperty(m_gnomeDesktopSettings, watchedProperty);
+    }
+
+    // Font rendering falls back to XSETTINGS when GSettings don't have it
+    watchXSettingsProperty("gtk-xft-antialias", QStringLiteral("font-antialiasing"));
+    watchXSettingsProperty("gtk-xft-rgba", QStringLiteral("font-antialiasing"));
+    watchXSettingsProperty("gtk-xft-hinting", QStringLiteral("font-hinting"));
+    watchXSettingsProperty("gtk-xft-hintstyle", QStringLiteral("font-hinting"));
+}
+
+void GSettingsHintProvider::watchSettingsProperty(GSettings *settings, const QString &property)
+{
+    if (!settings) {
+        return;
+    }
+
+    const QPair<GSettings *, QString> handlerKey(settings, property);
+    const bool interested = m_interests & interestsForKey(property);
+    const bool watched = m_signalHandlers.contains(handlerKey);
+
+    if (interested && !watched) {
+        const QString signal = QStringLiteral("changed::") + property;
+        m_signalHandlers.insert(handlerKey, g_signal_connect(settings, signal.toStdString().c_str(), G_CALLBACK(gsettingPropertyChanged), this));
+        // We might have missed a change while we were not watching the property
+        gsettingPropertyChanged(settings, property.toUtf8().data(), this);
+    } else if (!interested && watched) {
+        g_signal_handler_disconnect(settings, m_signalHandlers.take(handlerKey));
+    }
+}
+
+void GSettingsHintProvider::watchXSettingsProperty(const char *property, const QString &key)
+{
+    GtkSettings *settings = gtk_settings_get_default();
+    if (!settings) {
+        return;
+    }
+
+    const QString handlerKey = QString::fromLatin1(property);
+    const bool interested = m_interests & interestsForKey(key);
+    const bool watched = m_xsettingsHandlers.contains(handlerKey);
+
+    if (interested && !watched) {
+        const QByteArray signal = QByteArrayLiteral("notify::") + property;
+        m_xsettingsHandlers.insert(handlerKey, g_signal_connect(settings, signal.constData(), G_CALLBACK(xsettingPropertyChanged), this));
+        // We might have missed a change while we were not watching the property
+        if (loadFonts()) {
+            Q_EMIT fontChanged();
+        }
+    } else if (!interested && watched) {
+        g_signal_handler_disconnect(settings, m_xsettingsHandlers.take(handlerKey));
+    }
+}
+
+void GSettingsHintProvider::xsettingPropertyChanged(GtkSettings *settings, GParamSpec *pspec, GSettingsHintProvider *hintProvider)
+{
+    Q_UNUSED(settings)
+
+    qCDebug(QGnomePlatformGSettingsHintProvider) << "XSETTINGS property change: " << pspec->name;
+
+    if (hintProvider->loadFonts()) {
+        Q_EMIT hintProvider->fontChanged();
+    }
+}
+
 void GSettingsHintProvider::gsettingPropertyChanged(GSettings *settings, gchar *key, GSettingsHintProvider *hintProvider)
 {
     Q_UNUSED(settings)
@@ -108,76 +185,138 @@ void GSettingsHintProvider::gsettingPropertyChanged(GSettings *settings, gchar *
     qCDebug(QGnomePlatformGSettingsHintProvider) << "GSetting property change: " << key;
 
     if (changedProperty == QStringLiteral("gtk-theme") || changedProperty == QStringLiteral("color-scheme")) {
-        hintProvider->loadTheme();
-        Q_EMIT hintProvider->themeChanged();
+        if (hintProvider->loadTheme()) {
+            Q_EMIT hintProvider->themeChanged();
+            // Fallback icon theme depends on whether we use dark variant
+            if (hintProvider->loadIconTheme()) {
+                Q_EMIT hintProvider->iconThemeChanged();
+            }
+        }
     } else if (changedProperty == QStringLiteral("icon-theme")) {
-        hintProvider->loadIconTheme();
-        Q_EMIT hintProvider->iconThemeChanged();
+        if (hintProvider->loadIconTheme()) {
+            Q_EMIT hintProvider->iconThemeChanged();
+        }
     } else if (changedProperty == QStringLiteral("cursor-blink-time")) {
-        hintProvider->loadCursorBlinkTime();
-        Q_EMIT hintProvider->cursorBlinkTimeChanged();
+        if (hintProvider->loadCursorBlinkTime()) {
+            Q_EMIT hintProvider->cursorBlinkTimeChanged();
+        }
     } else if (changedProperty == QStringLiteral("font-name") || changedProperty == QStringLiteral("monospace-font-name")
-               || changedProperty == QStringLiteral("titlebar-font")) {
-        hintProvider->loadFonts();
-        Q_EMIT hintProvider->fontChanged();
+               || changedProperty == QStringLiteral("titlebar-font") || changedProperty == QStringLiteral("font-antialiasing")
+               || changedProperty == QStringLiteral("font-hinting")) {
+        if (hintProvider->loadFonts()) {
+            Q_EMIT hintProvider->fontChanged();
+        }
     } else if (changedProperty == QStringLiteral("cursor-size")) {
-        hintProvider->loadCursorSize();
-        ;
-        Q_EMIT hintProvider->fontChanged();
+        if (hintProvider->loadCursorSize()) {
+            Q_EMIT hintProvider->cursorSizeChanged();
+        }
     } else if (changedProperty == QStringLiteral("cursor-theme")) {
-        hintProvider->loadCursorTheme();
-        Q_EMIT hintProvider->cursorThemeChanged();
+        if (hintProvider->loadCursorTheme()) {
+            Q_EMIT hintProvider->cursorThemeChanged();
+        }
     } else if (changedProperty == QStringLiteral("button-layout")) {
-        hintProvider->loadTitlebar();
-        Q_EMIT hintProvider->titlebarChanged();
+        if (hintProvider->loadTitlebar()) {
+            Q_EMIT hintProvider->titlebarChanged();
+        }
     }
 }
 
-void GSettingsHintProvider::loadCursorBlinkTime()
+bool GSettingsHintProvider::loadCursorBlinkTime()
 {
     const int cursorBlinkTime = getSettingsProperty<int>(QStringLiteral("cursor-blink-time"));
-    setCursorBlinkTime(cursorBlinkTime);
+    return setCursorBlinkTime(cursorBlinkTime);
 }
 
-void GSettingsHintProvider::loadCursorSize()
+bool GSettingsHintProvider::loadCursorSize()
 {
     const int cursorSize = getSettingsProperty<int>(QStringLiteral("cursor-size"));
-    setCursorSize(cursorSize);
+    return setCursorSize(cursorSize);
 }
 
-void GSettingsHintProvider::loadCursorTheme()
+bool GSettingsHintProvider::loadCursorTheme()
 {
     const QString cursorTheme = getSettingsProperty<QString>(QStringLiteral("cursor-theme"));
-    setCursorTheme(cursorTheme);
+    return setCursorTheme(cursorTheme);
 }
 
-void GSettingsHintProvider::loadIconTheme()
+bool GSettingsHintProvider::loadIconTheme()
 {
     const QString systemIconTheme = getSettingsProperty<QString>(QStringLiteral("icon-theme"));
-    setIconTheme(systemIconTheme);
+    return setIconTheme(systemIconTheme);
 }
 
-void GSettingsHintProvider::loadFonts()
+bool GSettingsHintProvider::loadFonts()
 {
     const QString fontName = getSettingsProperty<QString>(QStringLiteral("font-name"));
     const QString monospaceFontName = getSettingsProperty<QString>(QStringLiteral("monospace-font-name"));
     const QString titlebarFontName = getSettingsProperty<QString>(QStringLiteral("titlebar-font"));
 
-    setFonts(fontName, monospaceFontName, titlebarFontName);
+    const bool fontsChanged = setFonts(fontName, monospaceFontName, titlebarFontName);
+    const bool renderingChanged = loadFontRendering();
+    return fontsChanged || renderingChanged;
+}
+
+bool GSettingsHintProvider::loadFontRendering()
+{
+    QString antialiasing;
+    QString hinting;
+
+    // Font rendering keys were moved to org.gnome.desktop.interface in GNOME 42
+    GSettingsSchema *schema = nullptr;
+    if (m_settings) {
+        g_object_get(G_OBJECT(m_settings), "settings-schema", &schema, NULL);
+    }
+    if (schema) {
+        if (g_settings_schema_has_key(schema, "font-antialiasing")) {
+            antialiasing = getSettingsProperty<QString>(QStringLiteral("font-antialiasing"));
+        }
+        if (g_settings_schema_has_key(schema, "font-hinting")) {
+            hinting = getSettingsProperty<QString>(QStringLiteral("font-hinting"));
+        }
+        g_settings_schema_unref(schema);
+    }
+
+    // Otherwise use what we get from XSETTINGS
+    if (antialiasing.isEmpty()) {
+        gint antialias = -1;
+        gchar *rgba = nullptr;
+        g_object_get(gtk_settings_get_default(), "gtk-xft-antialias", &antialias, "gtk-xft-rgba", &rgba, NULL);
+        if (antialias == 0) {
+            antialiasing = QStringLiteral("none");
+        } else if (antialias == 1) {
+            antialiasing = (!rgba || g_strcmp0(rgba, "none") == 0) ? QStringLiteral("grayscale") : QStringLiteral("rgba");
+        }
+        g_free(rgba);
+    }
+
+    if (hinting.isEmpty()) {
+        gint hint = -1;
+        gchar *hintStyle = nullptr;
+        g_object_get(gtk_settings_get_default(), "gtk-xft-hinting", &hint, "gtk-xft-hintstyle", &hintStyle, NULL);
+        if (hint == 0) {
+            hinting = QStringLiteral("none");
+        } else if (hint == 1 && hintStyle) {
+            // hintnone, hintslight, hintmedium or hintfull
+            hinting = QString::fromUtf8(hintStyle).mid(4);
+        }
+        g_free(hintStyle);
+    }
+
+    return setFontRendering(antialiasing, hinting);
 }
 
-void GSettingsHintProvider::loadTitlebar()
+bool GSettingsHintProvider::loadTitlebar()
 {
     const QString buttonLayout = getSettingsProperty<QString>("button-layout");
-    setTitlebar(buttonLayout);
+    return setTitlebar(buttonLayout);
 }
 
-void GSettingsHintProvider::loadTheme()
+bool GSettingsHintProvider::loadTheme()
 {
     const QString colorScheme = getSettingsProperty<QString>(QStringLiteral("color-scheme"));
     const QString theme = getSettingsProperty<QString>(QStringLiteral("gtk-theme"));
     const GnomeSettings::Appearance appearance = colorScheme == QStringLiteral("prefer-dark") ? GnomeSettings::PreferDark : GnomeSettings::PreferLight;
-    setTheme(theme, appearance);
+    return setTheme(theme, appearance);
 }
 
 void GSettingsHintProvider::loadStaticHints()
@@ -39,8 +39,11 @@ public:
     explicit GSettingsHintProvider(QObject *parent = nullptr);
     virtual ~GSettingsHintProvider();
 
+    void setInterests(GnomeSettings::SettingsInterests interests) override;
+
 protected:
     static void gsettingPropertyChanged(GSettings *settings, gchar *key, GSettingsHintProvider *hintProvider);
+    static void xsettingPropertyChanged(GtkSettings *settings, GParamSpec *pspec, GSettingsHintProvider *hintProvider);
 
 private:
     template<typename T>
@@ -48,18 +51,26 @@ private:
     template<typename T>
     T getSettingsProperty(const QString &property, bool *ok = nullptr);
 
-    void loadCursorBlinkTime();
-    void loadCursorSize();
-    void loadCursorTheme();
-    void loadIconTheme();
-    void loadFonts();
-    void loadTheme();
-    void loadTitlebar();
+    void watchSettingsProperty(GSettings *settings, const QString &property);
+    void watchXSettingsProperty(const char *property, const QString &key);
+
+    bool loadCursorBlinkTime();
+    bool loadCursorSize();
+    bool loadCursorTheme();
+    bool loadIconTheme();
+    bool loadFonts();
+    bool loadFontRendering();
+    bool loadTheme();
+    bool loadTitlebar();
     void loadStaticHints();
 
     GSettings *m_cinnamonSettings = nullptr;
     GSettings *m_gnomeDesktopSettings = nullptr;
     GSettings *m_settings = nullptr;
+
+    QHash<QPair<GSettings *, QString>, gulong> m_signalHandlers;
+    // Font rendering fallback, XSETTINGS properties of GtkSettings
+    QHash<QString, gulong> m_xsettingsHandlers;
 };
 
 #endif // GSETTINGS_HINT_PROVIDER_H
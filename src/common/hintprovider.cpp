@@ -42,36 +42,81 @@ HintProvider::HintProvider(QObject *parent)
 
 HintProvider::~HintProvider()
 {
-    qDeleteAll(m_fonts);
 }
 
-void HintProvider::setCursorBlinkTime(int cursorBlinkTime)
+void HintProvider::setInterests(GnomeSettings::SettingsInterests interests)
 {
-    if (cursorBlinkTime >= 100) {
-        qCDebug(QGnomePlatformHintProvider) << "Cursor blink time: " << cursorBlinkTime;
-        m_hints[QPlatformTheme::CursorFlashTime] = cursorBlinkTime;
-    } else {
-        m_hints[QPlatformTheme::CursorFlashTime] = 1200;
+    m_interests = interests;
+}
+
+GnomeSettings::SettingsInterests HintProvider::interestsForKey(const QString &key)
+{
+    // Both application palette and decoration colors depend on the theme
+    if (key == QStringLiteral("gtk-theme") || key == QStringLiteral("color-scheme") || key == QStringLiteral("accent-color") || key == QStringLiteral("contrast")) {
+        return GnomeSettings::ApplicationInterest | GnomeSettings::QuickInterest | GnomeSettings::DecorationInterest;
+    }
+
+    // Font rendering applies to titlebar font as well
+    if (key == QStringLiteral("font-antialiasing") || key == QStringLiteral("font-hinting")) {
+        return GnomeSettings::ApplicationInterest | GnomeSettings::QuickInterest | GnomeSettings::DecorationInterest;
+    }
+
+    if (key == QStringLiteral("titlebar-font") || key == QStringLiteral("button-layout")) {
+        return GnomeSettings::DecorationInterest;
+    }
+
+    if (key == QStringLiteral("icon-theme") || key == QStringLiteral("cursor-blink-time") || key == QStringLiteral("font-name")
+        || key == QStringLiteral("cursor-size") || key == QStringLiteral("cursor-theme")) {
+        return GnomeSettings::ApplicationInterest | GnomeSettings::QuickInterest;
+    }
+
+    // Qt Quick Controls styles don't use the fixed font
+    if (key == QStringLiteral("monospace-font-name")) {
+        return GnomeSettings::ApplicationInterest;
+    }
+
+    return {};
+}
+
+bool HintProvider::setCursorBlinkTime(int cursorBlinkTime)
+{
+    const int flashTime = cursorBlinkTime >= 100 ? cursorBlinkTime : 1200;
+    if (m_hints.value(QPlatformTheme::CursorFlashTime) == flashTime) {
+        return false;
     }
+
+    qCDebug(QGnomePlatformHintProvider) << "Cursor blink time: " << flashTime;
+    m_hints[QPlatformTheme::CursorFlashTime] = flashTime;
+    return true;
 }
 
-void HintProvider::setCursorSize(int cursorSize)
+bool HintProvider::setCursorSize(int cursorSize)
 {
+    if (m_cursorSize == cursorSize) {
+        return false;
+    }
+
     m_cursorSize = cursorSize;
 #if QT_VERSION >= QT_VERSION_CHECK(6, 5, 0)
     m_hints[QPlatformTheme::MouseCursorSize] = QSize(cursorSize, cursorSize);
 #endif
+    return true;
 }
 
-void HintProvider::setCursorTheme(const QString &cursorTheme)
+bool HintProvider::setCursorTheme(const QString &cursorTheme)
 {
+    if (m_cursorTheme == cursorTheme) {
+        return false;
+    }
+
     m_cursorTheme = cursorTheme;
 #if QT_VERSION >= QT_VERSION_CHECK(6, 5, 0)
     m_hints[QPlatformTheme::MouseCursorTheme] = cursorTheme;
 #endif
+    return true;
 }
 
-void HintProvider::setIconTheme(const QString &iconTheme)
+bool HintProvider::setIconTheme(const QString &iconTheme)
 {
     bool useDarkTheme = false;
     if (m_canRelyOnAppearance) {
@@ -83,48 +128,130 @@ void HintProvider::setIconTheme(const QString &iconTheme)
     const QString breezeTheme = useDarkTheme ? QStringLiteral("breeze-dark") : QStringLiteral("breeze");
     const QString adwaitaTheme = QStringLiteral("Adwaita");
 
+    QString themeName;
+    QString fallbackThemeName;
     if (!iconTheme.isEmpty() && iconTheme != adwaitaTheme) {
-        m_hints[QPlatformTheme::SystemIconThemeName] = iconTheme;
-        m_hints[QPlatformTheme::SystemIconFallbackThemeName] = adwaitaTheme;
+        themeName = iconTheme;
+        fallbackThemeName = adwaitaTheme;
     } else {
-        m_hints[QPlatformTheme::SystemIconThemeName] = adwaitaTheme;
-        m_hints[QPlatformTheme::SystemIconFallbackThemeName] = breezeTheme;
+        themeName = adwaitaTheme;
+        fallbackThemeName = breezeTheme;
+    }
+
+    if (m_hints.value(QPlatformTheme::SystemIconThemeName) == themeName && m_hints.value(QPlatformTheme::SystemIconFallbackThemeName) == fallbackThemeName) {
+        return false;
+    }
+
+    m_hints[QPlatformTheme::SystemIconThemeName] = themeName;
+    m_hints[QPlatformTheme::SystemIconFallbackThemeName] = fallbackThemeName;
+
+    qCDebug(QGnomePlatformHintProvider) << "Icon theme: " << themeName;
+    qCDebug(QGnomePlatformHintProvider) << "Fallback icon theme: " << fallbackThemeName;
+    return true;
+}
+
+bool HintProvider::updateFont(QPlatformTheme::Font type, const QFont &font)
+{
+    if (m_fonts.contains(type) && m_fonts.value(type) == font) {
+        return false;
+    }
+
+    m_fonts[type] = font;
+    return true;
+}
+
+bool HintProvider::setFonts(const QString &systemFont, const QString &monospaceFont, const QString &titlebarFont)
+{
+    bool changed = false;
+
+    const QFont font = Utils::qt_fontFromString(systemFont);
+    if (updateFont(QPlatformTheme::SystemFont, font)) {
+        qCDebug(QGnomePlatformHintProvider) << "Font name: " << font.family() << " (size " << font.pointSize() << ")";
+        changed = true;
+    }
+
+    const QFont fixedFont = Utils::qt_fontFromString(monospaceFont);
+    if (updateFont(QPlatformTheme::FixedFont, fixedFont)) {
+        qCDebug(QGnomePlatformHintProvider) << "Monospace font name: " << fixedFont.family() << " (size " << fixedFont.pointSize() << ")";
+        changed = true;
+    }
+
+    const QFont tbarFont = Utils::qt_fontFromString(titlebarFont);
+    if (updateFont(QPlatformTheme::TitleBarFont, tbarFont)) {
+        qCDebug(QGnomePlatformHintProvider) << "TitleBar font name: " << tbarFont.family() << " (size " << tbarFont.pointSize() << ")";
+        changed = true;
     }
 
-    qCDebug(QGnomePlatformHintProvider) << "Icon theme: " << m_hints[QPlatformTheme::SystemIconThemeName].toString();
-    qCDebug(QGnomePlatformHintProvider) << "Fallback icon theme: " << m_hints[QPlatformTheme::SystemIconFallbackThemeName].toString();
+    return changed;
 }
 
-void HintProvider::setFonts(const QString &systemFont, const QString &monospaceFont, const QString &titlebarFont)
+bool HintProvider::setFontRendering(const QString &antialiasing, const QString &hinting)
 {
-    qDeleteAll(m_fonts);
-    m_fonts.clear();
+    // Subpixel antialiasing is the default, it's also the most expensive one
+    QFont::StyleStrategy styleStrategy = QFont::PreferDefault;
+    if (antialiasing == QStringLiteral("none")) {
+        styleStrategy = QFont::NoAntialias;
+    } else if (antialiasing == QStringLiteral("grayscale")) {
+        styleStrategy = QFont::NoSubpixelAntialias;
+    }
 
-    QFont *font = Utils::qt_fontFromString(systemFont);
-    m_fonts[QPlatformTheme::SystemFont] = font;
-    qCDebug(QGnomePlatformHintProvider) << "Font name: " << font->family() << " (size " << font->pointSize() << ")";
+    QFont::HintingPreference hintingPreference = QFont::PreferDefaultHinting;
+    if (hinting == QStringLiteral("none")) {
+        hintingPreference = QFont::PreferNoHinting;
+    } else if (hinting == QStringLiteral("slight")) {
+        hintingPreference = QFont::PreferVerticalHinting;
+    } else if (hinting == QStringLiteral("medium") || hinting == QStringLiteral("full")) {
+        hintingPreference = QFont::PreferFullHinting;
+    }
 
-    QFont *fixedFont = Utils::qt_fontFromString(monospaceFont);
-    m_fonts[QPlatformTheme::FixedFont] = fixedFont;
-    qCDebug(QGnomePlatformHintProvider) << "Monospace font name: " << fixedFont->family() << " (size " << fixedFont->pointSize() << ")";
+    if (m_fontStyleStrategy == styleStrategy && m_fontHintingPreference == hintingPreference) {
+        return false;
+    }
 
-    QFont *tbarFont = Utils::qt_fontFromString(titlebarFont);
-    m_fonts[QPlatformTheme::TitleBarFont] = tbarFont;
-    qCDebug(QGnomePlatformHintProvider) << "TitleBar font name: " << tbarFont->family() << " (size " << tbarFont->pointSize() << ")";
+    qCDebug(QGnomePlatformHintProvider) << "Font antialiasing: " << antialiasing;
+    m_fontStyleStrategy = styleStrategy;
+    qCDebug(QGnomePlatformHintProvider) << "Font hinting: " << hinting;
+    m_fontHintingPreference = hintingPreference;
+    return true;
 }
 
-void HintProvider::setTitlebar(const QString &buttonLayout)
+bool HintProvider::setTitlebar(const QString &buttonLayout)
 {
-    m_titlebarButtonPlacement = Utils::titlebarButtonPlacementFromString(buttonLayout);
-    m_titlebarButtons = Utils::titlebarButtonsFromString(buttonLayout);
+    const GnomeSettings::TitlebarButtonsPlacement buttonPlacement = Utils::titlebarButtonPlacementFromString(buttonLayout);
+    const GnomeSettings::TitlebarButtons buttons = Utils::titlebarButtonsFromString(buttonLayout);
+    if (m_titlebarButtonPlacement == buttonPlacement && m_titlebarButtons == buttons) {
+        return false;
+    }
+
+    m_titlebarButtonPlacement = buttonPlacement;
+    m_titlebarButtons = buttons;
+    return true;
 }
 
-void HintProvider::setTheme(const QString &theme, GnomeSettings::Appearance appearance)
+bool HintProvider::setTheme(const QString &theme, GnomeSettings::Appearance appearance)
 {
+    if (m_gtkTheme == theme && m_appearance == appearance) {
+        return false;
+    }
+
     m_gtkTheme = theme;
     qCDebug(QGnomePlatformHintProvider) << "GTK theme: " << m_gtkTheme;
     m_appearance = appearance;
     qCDebug(QGnomePlatformHintProvider) << "Prefer dark theme: " << (appearance == GnomeSettings::PreferDark ? "yes" : "no");
+    return true;
+}
+
+bool HintProvider::setAccent(const QColor &accentColor, bool highContrast)
+{
+    if (m_accentColor == accentColor && m_highContrast == highContrast) {
+        return false;
+    }
+
+    m_accentColor = accentColor;
+    qCDebug(QGnomePlatformHintProvider) << "Accent color: " << accentColor;
+    m_highContrast = highContrast;
+    qCDebug(QGnomePlatformHintProvider) << "High contrast: " << (highContrast ? "yes" : "no");
+    return true;
 }
 
 void HintProvider::setStaticHints(int doubleClickTime, int longPressTime, int doubleClickDistance, int startDragDistance, int passwordMaskDelay)
@@ -22,13 +22,14 @@
 
 #include "gnomesettings.h"
 
+#include <QColor>
+#include <QFont>
 #include <QHash>
 #include <QObject>
 #include <QVariant>
 
 #include <qpa/qplatformtheme.h>
 
-class QFont;
 class QString;
 
 class HintProvider : public QObject
@@ -42,10 +43,26 @@ public:
     {
         return m_hints;
     }
-    inline QHash<QPlatformTheme::Font, QFont *> fonts() const
+    inline QHash<QPlatformTheme::Font, QFont> fonts() const
     {
         return m_fonts;
     }
+    // Font rendering, to be applied on all fonts
+    inline QFont::StyleStrategy fontStyleStrategy() const
+    {
+        return m_fontStyleStrategy;
+    }
+    inline QFont::HintingPreference fontHintingPreference() const
+    {
+        return m_fontHintingPreference;
+    }
+
+    // Only settings with matching interest are watched for changes
+    inline GnomeSettings::SettingsInterests interests() const
+    {
+        return m_interests;
+    }
+    virtual void setInterests(GnomeSettings::SettingsInterests interests);
 
     // Theme
     inline QString gtkTheme() const
@@ -64,6 +81,15 @@ public:
     {
         return m_canRelyOnAppearance;
     }
+    // Invalid when there is no accent color preference
+    inline QColor accentColor() const
+    {
+        return m_accentColor;
+    }
+    inline bool highContrast() const
+    {
+        return m_highContrast;
+    }
 
     // Cursor
     inline int cursorSize() const
@@ -95,19 +121,31 @@ Q_SIGNALS:
     void themeChanged();
 
 protected:
-    void setCursorBlinkTime(int cursorBlinkTime);
-    void setCursorSize(int cursorSize);
-    void setCursorTheme(const QString &cursorTheme);
-    void setIconTheme(const QString &iconTheme);
-    void setFonts(const QString &systemFont, const QString &monospaceFont, const QString &titlebarFont);
-    void setTheme(const QString &theme, GnomeSettings::Appearance appearance);
-    void setTitlebar(const QString &buttonLayout);
+    // All setters return whether the resolved value has changed, so that
+    // the providers emit change notifications only when there is a real change
+    bool setCursorBlinkTime(int cursorBlinkTime);
+    bool setCursorSize(int cursorSize);
+    bool setCursorTheme(const QString &cursorTheme);
+    bool setIconTheme(const QString &iconTheme);
+    bool setFonts(const QString &systemFont, const QString &monospaceFont, const QString &titlebarFont);
+    // Takes values of font-antialiasing and font-hinting GSettings keys
+    bool setFontRendering(const QString &antialiasing, const QString &hinting);
+    bool setTheme(const QString &theme, GnomeSettings::Appearance appearance);
+    bool setAccent(const QColor &accentColor, bool highContrast);
+    bool setTitlebar(const QString &buttonLayout);
     void setStaticHints(int doubleClickTime, int longPressTime, int doubleClickDistance, int startDragDistance, int passwordMaskDelay);
 
+    // Who needs to know about changes of given setting
+    static GnomeSettings::SettingsInterests interestsForKey(const QString &key);
+
+    GnomeSettings::SettingsInterests m_interests;
+
     // Theme
     QString m_gtkTheme;
     GnomeSettings::Appearance m_appearance = GnomeSettings::PreferLight;
     bool m_canRelyOnAppearance = false;
+    QColor m_accentColor;
+    bool m_highContrast = false;
 
     // Cursor
     int m_cursorSize = 0;
@@ -117,8 +155,14 @@ protected:
     GnomeSettings::TitlebarButtons m_titlebarButtons = GnomeSettings::TitlebarButton::CloseButton;
     GnomeSettings::TitlebarButtonsPlacement m_titlebarButtonPlacement = GnomeSettings::TitlebarButtonsPlacement::RightPlacement;
 
-    QHash<QPlatformTheme::Font, QFont *> m_fonts;
+    QHash<QPlatformTheme::Font, QFont> m_fonts;
+    QFont::StyleStrategy m_fontStyleStrategy = QFont::PreferDefault;
+    QFont::HintingPreference m_fontHintingPreference = QFont::PreferDefaultHinting;
     QHash<QPlatformTheme::ThemeHint, QVariant> m_hints;
+
+private:
+    // Keeps the current font when they are equal
+    bool updateFont(QPlatformTheme::Font type, const QFont &font);
 };
 
 #endif // GNOME_SETTINGS_P_H
@@ -53,6 +53,13 @@ const QDBusArgument &operator>>(const QDBusArgument &argument, QMap<QString, QVa
 
 PortalHintProvider::PortalHintProvider(QObject *parent, bool asynchronous)
     : HintProvider(parent)
+{
+    reload(asynchronous);
+
+    // We subscribe to SettingChanged once somebody is interested in the settings
+}
+
+void PortalHintProvider::reload(bool asynchronous)
 {
     QDBusMessage message = QDBusMessage::createMethodCall(QStringLiteral("org.freedesktop.portal.Desktop"),
                                                           QStringLiteral("/org/freedesktop/portal/desktop"),
@@ -66,15 +73,15 @@ PortalHintProvider::PortalHintProvider(QObject *parent, bool asynchronous)
     if (asynchronous) {
         qDBusRegisterMetaType<QMap<QString, QVariantMap>>();
         QDBusPendingCall pendingCall = QDBusConnection::sessionBus().asyncCall(message);
-        QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(pendingCall);
-        QObject::connect(watcher, &QDBusPendingCallWatcher::finished, [=](QDBusPendingCallWatcher *watcher) {
+        QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(pendingCall, this);
+        QObject::connect(watcher, &QDBusPendingCallWatcher::finished, this, [this](QDBusPendingCallWatcher *watcher) {
             QDBusPendingReply<QMap<QString, QVariantMap>> reply = *watcher;
             if (reply.isValid()) {
                 m_portalSettings = reply.value();
                 onSettingsReceived();
                 Q_EMIT settingsRecieved();
-                watcher->deleteLater();
             }
+            watcher->deleteLater();
         });
     } else {
         QDBusMessage resultMessage = QDBusConnection::sessionBus().call(message);
@@ -86,17 +93,13 @@ PortalHintProvider::PortalHintProvider(QObject *parent, bool asynchronous)
             onSettingsReceived();
         }
     }
-
-    QDBusConnection::sessionBus().connect(QString(),
-                                          QStringLiteral("/org/freedesktop/portal/desktop"),
-                                          QStringLiteral("org.freedesktop.portal.Settings"),
-                                          QStringLiteral("SettingChanged"),
-                                          this,
-                                          SLOT(settingChanged(QString, QString, QDBusVariant)));
 }
 
 void PortalHintProvider::onSettingsReceived()
 {
+    // We have the whole state now
+    m_staleGroups.clear();
+
     if (m_portalSettings.contains(QStringLiteral("org.freedesktop.appearance"))) {
         m_canRelyOnAppearance = true;
     }
@@ -110,81 +113,236 @@ void PortalHintProvider::onSettingsReceived()
     loadTitlebar();
     loadIconTheme();
 }
+
+void PortalHintProvider::setInterests(GnomeSettings::SettingsInterests interests)
+{
+    const GnomeSettings::SettingsInterests newInterests = interests & ~m_interests;
+    HintProvider::setInterests(interests);
+
+    updateSubscriptions();
+
+    if (!newInterests) {
+        return;
+    }
+
+    // We ignored changes of settings nobody was interested in, update them now
+    for (auto group = m_portalSettings.constBegin(); group != m_portalSettings.constEnd(); ++group) {
+        const QStringList keys = group.value().keys();
+        for (const QString &key : keys) {
+            if (interestsForKey(key) & newInterests) {
+                loadSetting(key);
+            }
+        }
+    }
+}
+
+static GnomeSettings::SettingsInterests interestsForGroup(const QString &group)
+{
+    if (group == QStringLiteral("org.gnome.desktop.wm.preferences")) {
+        return GnomeSettings::DecorationInterest;
+    }
+
+    return GnomeSettings::ApplicationInterest | GnomeSettings::QuickInterest | GnomeSettings::DecorationInterest;
+}
+
+void PortalHintProvider::updateSubscriptions()
+{
+    // Match only groups we read on the bus side, so that dbus-daemon doesn't wake us up
+    // for changes in all the other namespaces
+    const QStringList groups = {QStringLiteral("org.gnome.desktop.interface"),
+                                QStringLiteral("org.gnome.desktop.wm.preferences"),
+                                QStringLiteral("org.freedesktop.appearance")};
+
+    for (const QString &group : groups) {
+        const bool subscribe = m_interests & interestsForGroup(group);
+        if (subscribe == m_subscribedGroups.contains(group)) {
+            continue;
+        }
+
+        if (subscribe) {
+            QDBusConnection::sessionBus().connect(QStringLiteral("org.freedesktop.portal.Desktop"),
+                                                  QStringLiteral("/org/freedesktop/portal/desktop"),
+                                                  QStringLiteral("org.freedesktop.portal.Settings"),
+                                                  QStringLiteral("SettingChanged"),
+                                                  {group},
+                                                  QString(),
+                                                  this,
+                                                  SLOT(settingChanged(QString, QString, QDBusVariant)));
+            m_subscribedGroups.insert(group);
+
+            // We might have missed changes while we were not subscribed
+            if (m_staleGroups.remove(group)) {
+                readGroup(group);
+            }
+        } else {
+            QDBusConnection::sessionBus().disconnect(QStringLiteral("org.freedesktop.portal.Desktop"),
+                                                     QStringLiteral("/org/freedesktop/portal/desktop"),
+                                                     QStringLiteral("org.freedesktop.portal.Settings"),
+                                                     QStringLiteral("SettingChanged"),
+                                                     {group},
+                                                     QString(),
+                                                     this,
+                                                     SLOT(settingChanged(QString, QString, QDBusVariant)));
+            m_subscribedGroups.remove(group);
+            m_staleGroups.insert(group);
+        }
+    }
+}
+
+void PortalHintProvider::readGroup(const QString &group)
+{
+    QDBusMessage message = QDBusMessage::createMethodCall(QStringLiteral("org.freedesktop.portal.Desktop"),
+                                                          QStringLiteral("/org/freedesktop/portal/desktop"),
+                                                          QStringLiteral("org.freedesktop.portal.Settings"),
+                                                          QStringLiteral("ReadAll"));
+    message << QStringList{group};
+
+    qDBusRegisterMetaType<QMap<QString, QVariantMap>>();
+    QDBusPendingCall pendingCall = QDBusConnection::sessionBus().asyncCall(message);
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(pendingCall, this);
+    QObject::connect(watcher, &QDBusPendingCallWatcher::finished, this, [this, group](QDBusPendingCallWatcher *watcher) {
+        QDBusPendingReply<QMap<QString, QVariantMap>> reply = *watcher;
+        if (reply.isValid()) {
+            const QVariantMap settings = reply.value().value(group);
+            for (auto it = settings.constBegin(); it != settings.constEnd(); ++it) {
+                updateSetting(group, it.key(), it.value());
+            }
+        }
+        watcher->deleteLater();
+    });
+}
+
 void PortalHintProvider::settingChanged(const QString &group, const QString &key, const QDBusVariant &value)
 {
     qCDebug(QGnomePlatformPortalHintProvider) << "Setting property change: " << group << " : " << key;
-    m_portalSettings[group][key] = value.variant();
+    updateSetting(group, key, value.variant());
+}
 
-    if (key == QStringLiteral("gtk-theme") || key == QStringLiteral("color-scheme")) {
-        loadTheme();
-        Q_EMIT themeChanged();
+void PortalHintProvider::updateSetting(const QString &group, const QString &key, const QVariant &value)
+{
+    m_portalSettings[group][key] = value;
+
+    if (m_interests & interestsForKey(key)) {
+        loadSetting(key);
+    }
+}
+
+void PortalHintProvider::loadSetting(const QString &key)
+{
+    if (key == QStringLiteral("gtk-theme") || key == QStringLiteral("color-scheme") || key == QStringLiteral("accent-color") || key == QStringLiteral("contrast")) {
+        if (loadTheme()) {
+            Q_EMIT themeChanged();
+            // Fallback icon theme depends on whether we use dark variant
+            if (loadIconTheme()) {
+                Q_EMIT iconThemeChanged();
+            }
+        }
     } else if (key == QStringLiteral("icon-theme")) {
-        loadIconTheme();
-        Q_EMIT iconThemeChanged();
+        if (loadIconTheme()) {
+            Q_EMIT iconThemeChanged();
+        }
     } else if (key == QStringLiteral("cursor-blink-time")) {
-        loadCursorBlinkTime();
-        Q_EMIT cursorBlinkTimeChanged();
-    } else if (key == QStringLiteral("font-name") || key == QStringLiteral("monospace-font-name") || key == QStringLiteral("titlebar-font")) {
-        loadFonts();
-        Q_EMIT fontChanged();
+        if (loadCursorBlinkTime()) {
+            Q_EMIT cursorBlinkTimeChanged();
+        }
+    } else if (key == QStringLiteral("font-name") || key == QStringLiteral("monospace-font-name") || key == QStringLiteral("titlebar-font")
+               || key == QStringLiteral("font-antialiasing") || key == QStringLiteral("font-hinting")) {
+        if (loadFonts()) {
+            Q_EMIT fontChanged();
+        }
     } else if (key == QStringLiteral("cursor-size")) {
-        loadCursorSize();
-        Q_EMIT fontChanged();
+        if (loadCursorSize()) {
+            Q_EMIT cursorSizeChanged();
+        }
     } else if (key == QStringLiteral("cursor-theme")) {
-        loadCursorTheme();
-        Q_EMIT cursorThemeChanged();
+        if (loadCursorTheme()) {
+            Q_EMIT cursorThemeChanged();
+        }
     } else if (key == QStringLiteral("button-layout")) {
-        loadTitlebar();
-        Q_EMIT titlebarChanged();
+        if (loadTitlebar()) {
+            Q_EMIT titlebarChanged();
+        }
     }
 }
 
-void PortalHintProvider::loadCursorBlinkTime()
+bool PortalHintProvider::loadCursorBlinkTime()
 {
     const int cursorBlinkTime = m_portalSettings.value(QStringLiteral("org.gnome.desktop.interface")).value(QStringLiteral("cursor-blink-time")).toInt();
-    setCursorBlinkTime(cursorBlinkTime);
+    return setCursorBlinkTime(cursorBlinkTime);
 }
 
-void PortalHintProvider::loadCursorSize()
+bool PortalHintProvider::loadCursorSize()
 {
     const int cursorSize = m_portalSettings.value(QStringLiteral("org.gnome.desktop.interface")).value(QStringLiteral("cursor-size")).toInt();
-    setCursorSize(cursorSize);
+    return setCursorSize(cursorSize);
 }
 
-void PortalHintProvider::loadCursorTheme()
+bool PortalHintProvider::loadCursorTheme()
 {
     const QString cursorTheme = m_portalSettings.value(QStringLiteral("org.gnome.desktop.interface")).value(QStringLiteral("cursor-theme")).toString();
-    setCursorTheme(cursorTheme);
+    return setCursorTheme(cursorTheme);
 }
 
-void PortalHintProvider::loadIconTheme()
+bool PortalHintProvider::loadIconTheme()
 {
     const QString systemIconTheme = m_portalSettings.value(QStringLiteral("org.gnome.desktop.interface")).value(QStringLiteral("icon-theme")).toString();
-    setIconTheme(systemIconTheme);
+    return setIconTheme(systemIconTheme);
 }
 
-void PortalHintProvider::loadFonts()
+bool PortalHintProvider::loadFonts()
 {
     const QString fontName = m_portalSettings.value(QStringLiteral("org.gnome.desktop.interface")).value(QStringLiteral("font-name")).toString();
     const QString monospaceFontName =
         m_portalSettings.value(QStringLiteral("org.gnome.desktop.interface")).value(QStringLiteral("monospace-font-name")).toString();
     const QString titlebarFontName =
         m_portalSettings.value(QStringLiteral("org.gnome.desktop.wm.preferences")).value(QStringLiteral("titlebar-font")).toString();
-    setFonts(fontName, monospaceFontName, titlebarFontName);
+    const QString antialiasing = m_portalSettings.value(QStringLiteral("org.gnome.desktop.interface")).value(QStringLiteral("font-antialiasing")).toString();
+    const QString hinting = m_portalSettings.value(QStringLiteral("org.gnome.desktop.interface")).value(QStringLiteral("font-hinting")).toString();
+
+    const bool fontsChanged = setFonts(fontName, monospaceFontName, titlebarFontName);
+    const bool renderingChanged = setFontRendering(antialiasing, hinting);
+    return fontsChanged || renderingChanged;
 }
 
-void PortalHintProvider::loadTitlebar()
+bool PortalHintProvider::loadTitlebar()
 {
     const QString buttonLayout = m_portalSettings.value(QStringLiteral("org.gnome.desktop.wm.preferences")).value(QStringLiteral("button-layout")).toString();
-    setTitlebar(buttonLayout);
+    return setTitlebar(buttonLayout);
+}
+
+static QColor accentColorFromVariant(const QVariant &value)
+{
+    // Accent color is sent as (ddd) struct with RGB values, any value out of range means it's not set
+    if (!value.canConvert<QDBusArgument>()) {
+        return QColor();
+    }
+
+    double red = -1;
+    double green = -1;
+    double blue = -1;
+    const QDBusArgument argument = value.value<QDBusArgument>();
+    argument.beginStructure();
+    argument >> red >> green >> blue;
+    argument.endStructure();
+
+    if (red < 0 || red > 1 || green < 0 || green > 1 || blue < 0 || blue > 1) {
+        return QColor();
+    }
+
+    return QColor::fromRgbF(red, green, blue);
 }
 
-void PortalHintProvider::loadTheme()
+bool PortalHintProvider::loadTheme()
 {
+    const QVariantMap appearanceSettings = m_portalSettings.value(QStringLiteral("org.freedesktop.appearance"));
     const QString theme = m_portalSettings.value(QStringLiteral("org.gnome.desktop.interface")).value(QStringLiteral("gtk-theme")).toString();
-    const GnomeSettings::Appearance appearance = static_cast<GnomeSettings::Appearance>(
-        m_portalSettings.value(QStringLiteral("org.freedesktop.appearance")).value(QStringLiteral("color-scheme")).toUInt());
-    setTheme(theme, appearance);
+    const GnomeSettings::Appearance appearance = static_cast<GnomeSettings::Appearance>(appearanceSettings.value(QStringLiteral("color-scheme")).toUInt());
+    const QColor accentColor = accentColorFromVariant(appearanceSettings.value(QStringLiteral("accent-color")));
+    const bool highContrast = appearanceSettings.value(QStringLiteral("contrast")).toUInt() == 1;
+
+    const bool themeChanged = setTheme(theme, appearance);
+    const bool accentChanged = setAccent(accentColor, highContrast);
+    return themeChanged || accentChanged;
 }
 
 void PortalHintProvider::loadStaticHints()
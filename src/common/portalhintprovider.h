@@ -22,6 +22,8 @@
 
 #include "hintprovider.h"
 
+#include <QSet>
+
 class QDBusVariant;
 class QFont;
 class QString;
@@ -34,6 +36,10 @@ public:
     explicit PortalHintProvider(QObject *parent = nullptr, bool asynchronous = false);
     virtual ~PortalHintProvider() = default;
 
+    void setInterests(GnomeSettings::SettingsInterests interests) override;
+    // Reads all settings again, emits settingsRecieved() when done asynchronously
+    void reload(bool asynchronous = false);
+
 Q_SIGNALS:
     void settingsRecieved();
 
@@ -42,17 +48,25 @@ private Q_SLOTS:
 
 private:
     void onSettingsReceived();
+    void updateSubscriptions();
+    void readGroup(const QString &group);
+    void updateSetting(const QString &group, const QString &key, const QVariant &value);
+    void loadSetting(const QString &key);
 
-    void loadCursorBlinkTime();
-    void loadCursorSize();
-    void loadCursorTheme();
-    void loadIconTheme();
-    void loadFonts();
-    void loadTheme();
-    void loadTitlebar();
+    bool loadCursorBlinkTime();
+    bool loadCursorSize();
+    bool loadCursorTheme();
+    bool loadIconTheme();
+    bool loadFonts();
+    bool loadTheme();
+    bool loadTitlebar();
     void loadStaticHints();
 
     QMap<QString, QVariantMap> m_portalSettings;
+
+    // Groups we receive SettingChanged for and groups which might be outdated as we were not
+    QSet<QString> m_subscribedGroups;
+    QSet<QString> m_staleGroups;
 };
 
 #endif // PORTAL_HINT_PROVIDER_H
@@ -19,57 +19,277 @@
 
 #include "utils.h"
 
+#include <QCache>
 #include <QFont>
+#include <QLocale>
+#include <QStringList>
+#include <QStringView>
 
-#include <pango/pango.h>
+#include <cmath>
+
+// Number of parsed font descriptions we keep around
+#define FONT_CACHE_SIZE 16
 
 namespace Utils
 {
 
-// FIXME: duplicate
-QFont *qt_fontFromString(const QString &name)
+// Parser for Pango font descriptions, following pango_font_description_from_string():
+// "[FAMILY-LIST] [STYLE-OPTIONS] [SIZE] [VARIATIONS] [FEATURES]"
+namespace
 {
-    QFont *font = new QFont(QLatin1String("Sans"), 10);
-
-    PangoFontDescription *desc = pango_font_description_from_string(name.toUtf8());
-    font->setPointSizeF(static_cast<float>(pango_font_description_get_size(desc)) / PANGO_SCALE);
-
-    QString family = QString::fromUtf8(pango_font_description_get_family(desc));
-    if (!family.isEmpty()) {
-        font->setFamily(family);
-    }
-
-    const int weight = pango_font_description_get_weight(desc);
-    if (weight >= PANGO_WEIGHT_HEAVY) {
-        font->setWeight(QFont::Black);
-    } else if (weight >= PANGO_WEIGHT_ULTRABOLD) {
-        font->setWeight(QFont::ExtraBold);
-    } else if (weight >= PANGO_WEIGHT_BOLD) {
-        font->setWeight(QFont::Bold);
-    } else if (weight >= PANGO_WEIGHT_SEMIBOLD) {
-        font->setWeight(QFont::DemiBold);
-    } else if (weight >= PANGO_WEIGHT_MEDIUM) {
-        font->setWeight(QFont::Medium);
-    } else if (weight >= PANGO_WEIGHT_NORMAL) {
-        font->setWeight(QFont::Normal);
-    } else if (weight >= PANGO_WEIGHT_LIGHT) {
-        font->setWeight(QFont::Light);
-    } else if (weight >= PANGO_WEIGHT_ULTRALIGHT) {
-        font->setWeight(QFont::ExtraLight);
-    } else {
-        font->setWeight(QFont::Thin);
+struct FontField {
+    const char *name;
+    int value;
+};
+
+constexpr FontField styleFields[] = {{"Roman", QFont::StyleNormal}, {"Oblique", QFont::StyleOblique}, {"Italic", QFont::StyleItalic}};
+
+constexpr FontField variantFields[] = {{"Small-Caps", QFont::SmallCaps},
+                                       {"All-Small-Caps", QFont::SmallCaps},
+                                       {"Petite-Caps", QFont::SmallCaps},
+                                       {"All-Petite-Caps", QFont::SmallCaps},
+                                       {"Unicase", QFont::MixedCase},
+                                       {"Title-Caps", QFont::Capitalize}};
+
+// Pango weights
+constexpr FontField weightFields[] = {{"Thin", 100},
+                                      {"Ultra-Light", 200},
+                                      {"Extra-Light", 200},
+                                      {"Light", 300},
+                                      {"Semi-Light", 350},
+                                      {"Demi-Light", 350},
+                                      {"Book", 380},
+                                      {"Regular", 400},
+                                      {"Medium", 500},
+                                      {"Semi-Bold", 600},
+                                      {"Demi-Bold", 600},
+                                      {"Bold", 700},
+                                      {"Ultra-Bold", 800},
+                                      {"Extra-Bold", 800},
+                                      {"Heavy", 900},
+                                      {"Black", 900},
+                                      {"Ultra-Heavy", 1000},
+                                      {"Extra-Black", 1000}};
+
+constexpr FontField stretchFields[] = {{"Ultra-Condensed", QFont::UltraCondensed},
+                                       {"Extra-Condensed", QFont::ExtraCondensed},
+                                       {"Condensed", QFont::Condensed},
+                                       {"Semi-Condensed", QFont::SemiCondensed},
+                                       {"Semi-Expanded", QFont::SemiExpanded},
+                                       {"Expanded", QFont::Expanded},
+                                       {"Extra-Expanded", QFont::ExtraExpanded},
+                                       {"Ultra-Expanded", QFont::UltraExpanded}};
+
+// Accepted, but there is nothing like that in QFont
+constexpr FontField gravityFields[] = {{"Not-Rotated", 0},
+                                       {"South", 0},
+                                       {"Upside-Down", 0},
+                                       {"North", 0},
+                                       {"Rotated-Left", 0},
+                                       {"East", 0},
+                                       {"Rotated-Right", 0},
+                                       {"West", 0}};
+
+struct FontDescription {
+    QStringView families;
+    double size = 0;
+    bool sizeInPixels = false;
+    int weight = 400;
+    int style = QFont::StyleNormal;
+    int capitalization = -1;
+    int stretch = -1;
+};
+} // namespace
+
+// Case insensitive, dashes in the field name are optional (e.g. "semibold" matches "Semi-Bold")
+static bool fieldMatches(QStringView word, const char *field)
+{
+    int i = 0;
+    for (; *field; ++field) {
+        if (i < word.size() && word.at(i).toLower() == QChar(QLatin1Char(*field)).toLower()) {
+            ++i;
+        } else if (*field != '-') {
+            return false;
+        }
     }
 
-    PangoStyle style = pango_font_description_get_style(desc);
-    if (style == PANGO_STYLE_ITALIC) {
-        font->setStyle(QFont::StyleItalic);
-    } else if (style == PANGO_STYLE_OBLIQUE) {
-        font->setStyle(QFont::StyleOblique);
+    return i == word.size();
+}
+
+template<size_t N>
+static bool findField(QStringView word, const FontField (&fields)[N], int *value)
+{
+    for (const FontField &field : fields) {
+        if (fieldMatches(word, field.name)) {
+            *value = field.value;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static bool parseStyleWord(QStringView word, FontDescription *description)
+{
+    int value = 0;
+    if (fieldMatches(word, "Normal")) {
+        return true;
+    } else if (findField(word, weightFields, &description->weight)) {
+        return true;
+    } else if (findField(word, styleFields, &description->style)) {
+        return true;
+    } else if (findField(word, variantFields, &description->capitalization)) {
+        return true;
+    } else if (findField(word, stretchFields, &description->stretch)) {
+        return true;
+    } else if (findField(word, gravityFields, &value)) {
+        return true;
+    }
+
+    // Numeric weight
+    bool ok = false;
+    value = QLocale::c().toInt(word, &ok);
+    if (ok && value > 0 && value <= 1000) {
+        description->weight = value;
+        return true;
+    }
+
+    return false;
+}
+
+static bool parseSize(QStringView word, FontDescription *description)
+{
+    const bool sizeInPixels = word.endsWith(QLatin1String("px"));
+    if (sizeInPixels) {
+        word.chop(2);
+    }
+
+    bool ok = false;
+    const double size = QLocale::c().toDouble(word, &ok);
+    if (!ok || size < 0 || !std::isfinite(size)) {
+        return false;
+    }
+
+    description->size = size;
+    description->sizeInPixels = sizeInPixels;
+    return true;
+}
+
+static QStringView lastWord(QStringView str)
+{
+    int start = str.size();
+    while (start > 0 && !str.at(start - 1).isSpace() && str.at(start - 1) != QLatin1Char(',')) {
+        --start;
+    }
+
+    return str.mid(start);
+}
+
+static FontDescription parseFontDescription(QStringView str)
+{
+    FontDescription description;
+    str = str.trimmed();
+
+    // Font variations and features are not supported
+    QStringView word = lastWord(str);
+    while (!word.isEmpty() && (word.startsWith(QLatin1Char('#')) || word.startsWith(QLatin1Char('@')))) {
+        str = str.chopped(word.size()).trimmed();
+        word = lastWord(str);
+    }
+
+    if (!word.isEmpty() && parseSize(word, &description)) {
+        str = str.chopped(word.size()).trimmed();
+        word = lastWord(str);
+    }
+
+    while (!word.isEmpty() && parseStyleWord(word, &description)) {
+        str = str.chopped(word.size()).trimmed();
+        word = lastWord(str);
+    }
+
+    while (str.endsWith(QLatin1Char(','))) {
+        str = str.chopped(1).trimmed();
+    }
+    description.families = str;
+
+    return description;
+}
+
+static QFont parseFontString(const QString &name)
+{
+    QFont font(QLatin1String("Sans"), 10);
+
+    const FontDescription description = parseFontDescription(name);
+
+    if (description.size > 0) {
+        if (description.sizeInPixels) {
+            font.setPixelSize(qMax(1, qRound(description.size)));
+        } else {
+            font.setPointSizeF(description.size);
+        }
+    }
+
+    QStringList families;
+    const QStringList familyList = description.families.toString().split(QLatin1Char(','));
+    for (const QString &family : familyList) {
+        const QString trimmedFamily = family.trimmed();
+        if (!trimmedFamily.isEmpty()) {
+            families << trimmedFamily;
+        }
+    }
+    if (!families.isEmpty()) {
+        font.setFamily(families.first());
+        if (families.size() > 1) {
+            font.setFamilies(families);
+        }
+    }
+
+    // Keep the same mapping as for Pango weights
+    const int weight = description.weight;
+    if (weight >= 900) {
+        font.setWeight(QFont::Black);
+    } else if (weight >= 800) {
+        font.setWeight(QFont::ExtraBold);
+    } else if (weight >= 700) {
+        font.setWeight(QFont::Bold);
+    } else if (weight >= 600) {
+        font.setWeight(QFont::DemiBold);
+    } else if (weight >= 500) {
+        font.setWeight(QFont::Medium);
+    } else if (weight >= 400) {
+        font.setWeight(QFont::Normal);
+    } else if (weight >= 300) {
+        font.setWeight(QFont::Light);
+    } else if (weight >= 200) {
+        font.setWeight(QFont::ExtraLight);
     } else {
-        font->setStyle(QFont::StyleNormal);
+        font.setWeight(QFont::Thin);
+    }
+
+    font.setStyle(static_cast<QFont::Style>(description.style));
+
+    if (description.capitalization >= 0) {
+        font.setCapitalization(static_cast<QFont::Capitalization>(description.capitalization));
+    }
+
+    if (description.stretch >= 0) {
+        font.setStretch(description.stretch);
+    }
+
+    return font;
+}
+
+QFont qt_fontFromString(const QString &name)
+{
+    // Font settings rarely change, but are re-read together whenever one of them changes
+    static QCache<QString, QFont> fontCache(FONT_CACHE_SIZE);
+
+    if (const QFont *font = fontCache.object(name)) {
+        return *font;
     }
 
-    pango_font_description_free(desc);
+    const QFont font = parseFontString(name);
+    fontCache.insert(name, new QFont(font));
     return font;
 }
 
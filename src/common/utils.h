@@ -22,12 +22,14 @@
 
 #include "gnomesettings.h"
 
-class QFont;
+#include <QFont>
+
 class QString;
 
 namespace Utils
 {
-QFont *qt_fontFromString(const QString &name);
+// Parses Pango font description (e.g. "Cantarell Bold 11"), results are cached
+QFont qt_fontFromString(const QString &name);
 GnomeSettings::TitlebarButtons titlebarButtonsFromString(const QString &layout);
 GnomeSettings::TitlebarButtonsPlacement titlebarButtonPlacementFromString(const QString &layout);
 }
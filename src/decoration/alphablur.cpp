@@ -0,0 +1,277 @@
+/*
+ * Copyright (C) 2026 The QGnomePlatform contributors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "alphablur.h"
+
+#include <QImage>
+
+#include <private/qsimd_p.h>
+
+#include <vector>
+
+// Three box blurs of this radius (relative to the requested one) are as wide
+// as the exponential blur Qt uses
+#define BOX_RADIUS_SCALE 0.6
+#define BOX_BLUR_PASSES 3
+
+namespace
+{
+struct RowOps {
+    void (*add)(quint16 *sums, const uchar *row, int width);
+    void (*subtract)(quint16 *sums, const uchar *row, int width);
+    void (*store)(uchar *row, const quint16 *sums, int width, quint16 multiplier);
+};
+
+void addRowScalar(quint16 *sums, const uchar *row, int from, int width)
+{
+    for (int x = from; x < width; ++x) {
+        sums[x] += row[x];
+    }
+}
+
+void subtractRowScalar(quint16 *sums, const uchar *row, int from, int width)
+{
+    for (int x = from; x < width; ++x) {
+        sums[x] -= row[x];
+    }
+}
+
+void storeRowScalar(uchar *row, const quint16 *sums, int from, int width, quint16 multiplier)
+{
+    for (int x = from; x < width; ++x) {
+        row[x] = uchar((quint32(sums[x]) * multiplier) >> 16);
+    }
+}
+
+#if defined(__SSE2__)
+void addRowSse2(quint16 *sums, const uchar *row, int width)
+{
+    const __m128i zero = _mm_setzero_si128();
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + x));
+        __m128i *sum = reinterpret_cast<__m128i *>(sums + x);
+        _mm_storeu_si128(sum, _mm_add_epi16(_mm_loadu_si128(sum), _mm_unpacklo_epi8(pixels, zero)));
+        _mm_storeu_si128(sum + 1, _mm_add_epi16(_mm_loadu_si128(sum + 1), _mm_unpackhi_epi8(pixels, zero)));
+    }
+    addRowScalar(sums, row, x, width);
+}
+
+void subtractRowSse2(quint16 *sums, const uchar *row, int width)
+{
+    const __m128i zero = _mm_setzero_si128();
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + x));
+        __m128i *sum = reinterpret_cast<__m128i *>(sums + x);
+        _mm_storeu_si128(sum, _mm_sub_epi16(_mm_loadu_si128(sum), _mm_unpacklo_epi8(pixels, zero)));
+        _mm_storeu_si128(sum + 1, _mm_sub_epi16(_mm_loadu_si128(sum + 1), _mm_unpackhi_epi8(pixels, zero)));
+    }
+    subtractRowScalar(sums, row, x, width);
+}
+
+void storeRowSse2(uchar *row, const quint16 *sums, int width, quint16 multiplier)
+{
+    const __m128i factor = _mm_set1_epi16(short(multiplier));
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        const __m128i *sum = reinterpret_cast<const __m128i *>(sums + x);
+        const __m128i low = _mm_mulhi_epu16(_mm_loadu_si128(sum), factor);
+        const __m128i high = _mm_mulhi_epu16(_mm_loadu_si128(sum + 1), factor);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(row + x), _mm_packus_epi16(low, high));
+    }
+    storeRowScalar(row, sums, x, width, multiplier);
+}
+#endif
+
+#if QT_COMPILER_SUPPORTS_HERE(AVX2)
+QT_FUNCTION_TARGET(AVX2) void addRowAvx2(quint16 *sums, const uchar *row, int width)
+{
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        const __m256i pixels = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(row + x)));
+        __m256i *sum = reinterpret_cast<__m256i *>(sums + x);
+        _mm256_storeu_si256(sum, _mm256_add_epi16(_mm256_loadu_si256(sum), pixels));
+    }
+    addRowScalar(sums, row, x, width);
+}
+
+QT_FUNCTION_TARGET(AVX2) void subtractRowAvx2(quint16 *sums, const uchar *row, int width)
+{
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        const __m256i pixels = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(row + x)));
+        __m256i *sum = reinterpret_cast<__m256i *>(sums + x);
+        _mm256_storeu_si256(sum, _mm256_sub_epi16(_mm256_loadu_si256(sum), pixels));
+    }
+    subtractRowScalar(sums, row, x, width);
+}
+
+QT_FUNCTION_TARGET(AVX2) void storeRowAvx2(uchar *row, const quint16 *sums, int width, quint16 multiplier)
+{
+    const __m256i factor = _mm256_set1_epi16(short(multiplier));
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        const __m256i values = _mm256_mulhi_epu16(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(sums + x)), factor);
+        const __m128i packed = _mm_packus_epi16(_mm256_castsi256_si128(values), _mm256_extracti128_si256(values, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(row + x), packed);
+    }
+    storeRowScalar(row, sums, x, width, multiplier);
+}
+#endif
+
+void addRowGeneric(quint16 *sums, const uchar *row, int width)
+{
+    addRowScalar(sums, row, 0, width);
+}
+
+void subtractRowGeneric(quint16 *sums, const uchar *row, int width)
+{
+    subtractRowScalar(sums, row, 0, width);
+}
+
+void storeRowGeneric(uchar *row, const quint16 *sums, int width, quint16 multiplier)
+{
+    storeRowScalar(row, sums, 0, width, multiplier);
+}
+
+bool rowOps(AlphaBlurPath path, RowOps *ops)
+{
+    switch (path) {
+    case DefaultAlphaBlurPath:
+        return rowOps(Avx2AlphaBlurPath, ops) || rowOps(Sse2AlphaBlurPath, ops) || rowOps(ScalarAlphaBlurPath, ops);
+    case ScalarAlphaBlurPath:
+        *ops = {addRowGeneric, subtractRowGeneric, storeRowGeneric};
+        return true;
+    case Sse2AlphaBlurPath:
+#if defined(__SSE2__)
+        *ops = {addRowSse2, subtractRowSse2, storeRowSse2};
+        return true;
+#else
+        return false;
+#endif
+    case Avx2AlphaBlurPath:
+#if QT_COMPILER_SUPPORTS_HERE(AVX2)
+        if (qCpuHasFeature(AVX2)) {
+            *ops = {addRowAvx2, subtractRowAvx2, storeRowAvx2};
+            return true;
+        }
+#endif
+        return false;
+    }
+
+    return false;
+}
+
+// Box blur of all columns at once, going down the rows with a running sum of the window.
+// Sums are kept in 16 bits, 255 * window size fits for any sensible radius. Dividing by the
+// window size is done as multiplying by 65536 / window size and keeping the high 16 bits
+void blurColumns(const RowOps &ops, const QImage &source, QImage &target, int radius, std::vector<quint16> &sums)
+{
+    const int width = source.width();
+    const int height = source.height();
+    const quint16 multiplier = quint16((65536 + 2 * radius) / (2 * radius + 1));
+
+    const uchar *sourceBits = source.constBits();
+    const qsizetype sourceStride = source.bytesPerLine();
+    uchar *targetBits = target.bits();
+    const qsizetype targetStride = target.bytesPerLine();
+
+    sums.assign(width, 0);
+    for (int y = 0; y < radius && y < height; ++y) {
+        ops.add(sums.data(), sourceBits + y * sourceStride, width);
+    }
+
+    for (int y = 0; y < height; ++y) {
+        if (y + radius < height) {
+            ops.add(sums.data(), sourceBits + (y + radius) * sourceStride, width);
+        }
+        ops.store(targetBits + y * targetStride, sums.data(), width, multiplier);
+        if (y - radius >= 0) {
+            ops.subtract(sums.data(), sourceBits + (y - radius) * sourceStride, width);
+        }
+    }
+}
+
+void transpose(const QImage &source, QImage &target)
+{
+    const int width = source.width();
+    const int height = source.height();
+
+    const uchar *sourceBits = source.constBits();
+    const qsizetype sourceStride = source.bytesPerLine();
+    uchar *targetBits = target.bits();
+    const qsizetype targetStride = target.bytesPerLine();
+
+    for (int y = 0; y < height; ++y) {
+        const uchar *sourceLine = sourceBits + y * sourceStride;
+        uchar *targetColumn = targetBits + y;
+        for (int x = 0; x < width; ++x) {
+            targetColumn[x * targetStride] = sourceLine[x];
+        }
+    }
+}
+
+void blurAllColumns(const RowOps &ops, QImage &image, QImage &scratch, int radius, std::vector<quint16> &sums)
+{
+    for (int pass = 0; pass < BOX_BLUR_PASSES; ++pass) {
+        blurColumns(ops, image, scratch, radius, sums);
+        std::swap(image, scratch);
+    }
+}
+} // namespace
+
+bool alphaBlurPathSupported(AlphaBlurPath path)
+{
+    RowOps ops;
+    return rowOps(path, &ops);
+}
+
+void blurAlphaImage(QImage &image, int radius, AlphaBlurPath path)
+{
+    Q_ASSERT(image.format() == QImage::Format_Alpha8);
+
+    const int boxRadius = qRound(radius * BOX_RADIUS_SCALE);
+    if (boxRadius < 1 || image.isNull()) {
+        return;
+    }
+
+    static const RowOps defaultOps = []() {
+        RowOps ops;
+        rowOps(DefaultAlphaBlurPath, &ops);
+        return ops;
+    }();
+    RowOps ops = defaultOps;
+    if (path != DefaultAlphaBlurPath && !rowOps(path, &ops)) {
+        ops = defaultOps;
+    }
+
+    std::vector<quint16> sums;
+
+    // Columns are blurred directly, rows as columns of the transposed image
+    QImage scratch(image.size(), QImage::Format_Alpha8);
+    blurAllColumns(ops, image, scratch, boxRadius, sums);
+
+    QImage transposed(image.height(), image.width(), QImage::Format_Alpha8);
+    transpose(image, transposed);
+    QImage transposedScratch(transposed.size(), QImage::Format_Alpha8);
+    blurAllColumns(ops, transposed, transposedScratch, boxRadius, sums);
+    transpose(transposed, image);
+}
@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2026 The QGnomePlatform contributors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef ALPHABLUR_H
+#define ALPHABLUR_H
+
+class QImage;
+
+// Implementations of the blur, by default the best one the CPU supports is used
+enum AlphaBlurPath {
+    DefaultAlphaBlurPath,
+    ScalarAlphaBlurPath,
+    Sse2AlphaBlurPath,
+    Avx2AlphaBlurPath,
+};
+
+// Whether the build and the CPU support the implementation, for tests and benchmarks
+bool alphaBlurPathSupported(AlphaBlurPath path);
+
+// Blurs an image in QImage::Format_Alpha8 in place, using three passes of a separable box
+// blur which give about the same spread as qt_blurImage() with the same radius. Unsupported
+// paths fall back to the default one
+void blurAlphaImage(QImage &image, int radius, AlphaBlurPath path = DefaultAlphaBlurPath);
+
+#endif // ALPHABLUR_H
@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2026 The QGnomePlatform contributors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "decorationbuttons.h"
+#include "decorationstyle.h"
+
+#if QT_VERSION >= 0x060000
+#include <AdwaitaQt6/adwaitacolors.h>
+#else
+#include <AdwaitaQt/adwaitacolors.h>
+#endif
+
+#include <QPainter>
+#include <QtMath>
+
+#include <map>
+#include <memory>
+#include <tuple>
+
+// Atlas layout
+#define BUTTON_COLUMNS 4
+#define STATE_ROWS 6
+
+namespace
+{
+int buttonColumn(Adwaita::ButtonType button)
+{
+    switch (button) {
+    case Adwaita::ButtonType::ButtonMaximize:
+        return 1;
+    case Adwaita::ButtonType::ButtonMinimize:
+        return 2;
+    case Adwaita::ButtonType::ButtonRestore:
+        return 3;
+    default:
+        return 0;
+    }
+}
+
+// Pressed buttons look the same as normal ones unless they have a frame
+int stateRow(bool renderFrame, bool sunken, bool active)
+{
+    const int frameState = renderFrame ? (sunken ? 2 : 1) : 0;
+    return (active ? 3 : 0) + frameState;
+}
+} // namespace
+
+DecorationButtons::DecorationButtons(const DecorationStyle &style, int buttonSize, qreal scale)
+    : m_variant(style.variant())
+    , m_foregroundColor(style.foregroundColor(true))
+    , m_foregroundInactiveColor(style.foregroundColor(false))
+    , m_buttonSize(buttonSize)
+    , m_scale(scale)
+    , m_cellSize(qCeil(buttonSize * scale))
+{
+    m_atlas = QImage(BUTTON_COLUMNS * m_cellSize, STATE_ROWS * m_cellSize, QImage::Format_ARGB32_Premultiplied);
+    m_atlas.fill(Qt::transparent);
+}
+
+DecorationButtons &DecorationButtons::forStyle(const DecorationStyle &style, int buttonSize, qreal scale)
+{
+    // Decorations are only ever painted from the GUI thread. Buttons are keyed on the colors
+    // they are rendered with, styles differing in other colors share them
+    static std::map<std::tuple<int, QRgb, QRgb, int, int>, std::unique_ptr<DecorationButtons>> buttons;
+
+    const auto key = std::make_tuple(int(style.variant()),
+                                     style.foregroundColor(true).rgba(),
+                                     style.foregroundColor(false).rgba(),
+                                     buttonSize,
+                                     qRound(scale * 100));
+    auto it = buttons.find(key);
+    if (it == buttons.end()) {
+        it = buttons.emplace(key, std::unique_ptr<DecorationButtons>(new DecorationButtons(style, buttonSize, scale))).first;
+    }
+
+    return *it->second;
+}
+
+void DecorationButtons::renderCell(int column, int row, Adwaita::ButtonType button, bool renderFrame, bool sunken, bool active)
+{
+    QPainter painter(&m_atlas);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.translate(column * m_cellSize, row * m_cellSize);
+    painter.setClipRect(0, 0, m_cellSize, m_cellSize);
+    painter.scale(m_scale, m_scale);
+
+    if (renderFrame) {
+        Adwaita::StyleOptions styleOptions(&painter, QRect(0, 0, m_buttonSize, m_buttonSize));
+        styleOptions.setMouseOver(true);
+        styleOptions.setSunken(sunken);
+        styleOptions.setColorVariant(m_variant);
+        styleOptions.setColor(Adwaita::Colors::buttonBackgroundColor(styleOptions));
+        styleOptions.setOutlineColor(Adwaita::Colors::buttonOutlineColor(styleOptions));
+        Adwaita::Renderer::renderFlatRoundedButtonFrame(styleOptions);
+    }
+
+    Adwaita::StyleOptions decorationButtonStyle(&painter, QRect(m_buttonSize / 4, m_buttonSize / 4, m_buttonSize / 2, m_buttonSize / 2));
+    decorationButtonStyle.setColor(active ? m_foregroundColor : m_foregroundInactiveColor);
+    Adwaita::Renderer::renderDecorationButton(decorationButtonStyle, button);
+}
+
+void DecorationButtons::paint(QPainter *painter, const QPoint &position, Adwaita::ButtonType button, bool renderFrame, bool sunken, bool active)
+{
+    const int column = buttonColumn(button);
+    const int row = stateRow(renderFrame, sunken, active);
+
+    const size_t cell = row * BUTTON_COLUMNS + column;
+    if (!m_renderedCells.test(cell)) {
+        renderCell(column, row, button, renderFrame, sunken, active);
+        m_renderedCells.set(cell);
+    }
+
+    const QRectF source(column * m_cellSize, row * m_cellSize, m_buttonSize * m_scale, m_buttonSize * m_scale);
+    painter->drawImage(QRectF(position, QSizeF(m_buttonSize, m_buttonSize)), m_atlas, source);
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2026 The QGnomePlatform contributors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef DECORATIONBUTTONS_H
+#define DECORATIONBUTTONS_H
+
+#include <QtGlobal>
+
+#if QT_VERSION >= 0x060000
+#include <AdwaitaQt6/adwaitarenderer.h>
+#else
+#include <AdwaitaQt/adwaitarenderer.h>
+#endif
+
+#include <QColor>
+#include <QImage>
+
+#include <bitset>
+
+class DecorationStyle;
+class QPainter;
+
+// Titlebar buttons for the colors of a decoration style, shared by all decorations in the process.
+// Every combination of button and state is rendered into an atlas the first time it
+// is needed, painting a button afterwards is a single image blit
+class DecorationButtons
+{
+public:
+    static DecorationButtons &forStyle(const DecorationStyle &style, int buttonSize, qreal scale);
+
+    // Paints the button with its top left corner at the given position, the frame is
+    // rendered only for buttons under the cursor
+    void paint(QPainter *painter, const QPoint &position, Adwaita::ButtonType button, bool renderFrame, bool sunken, bool active);
+
+private:
+    DecorationButtons(const DecorationStyle &style, int buttonSize, qreal scale);
+    Q_DISABLE_COPY(DecorationButtons)
+
+    void renderCell(int column, int row, Adwaita::ButtonType button, bool renderFrame, bool sunken, bool active);
+
+    // Colors the buttons are rendered with, taken from the style
+    Adwaita::ColorVariant m_variant;
+    QColor m_foregroundColor;
+    QColor m_foregroundInactiveColor;
+    int m_buttonSize;
+    qreal m_scale;
+    // Size of a cell in the atlas, in device pixels
+    int m_cellSize;
+
+    // One column for each button, one row for each state
+    QImage m_atlas;
+    std::bitset<32> m_renderedCells;
+};
+
+#endif // DECORATIONBUTTONS_H
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2026 The QGnomePlatform contributors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "decorationshadow.h"
+#include "alphablur.h"
+
+#include <QPainter>
+
+#include <map>
+#include <memory>
+#include <tuple>
+
+// Shadow shape
+#define SHADOW_BLUR_RADIUS 12
+#define SHADOW_CORNER_RADIUS 8
+#define SHADOW_COLOR_INSET 8
+
+DecorationShadow::DecorationShadow(const QColor &color, int shadowWidth, qreal scale)
+{
+    // Corners have to fit the rounded corner of the window and everything the blur spreads around it,
+    // everything in between is the same along the edge
+    m_cornerSize = shadowWidth + SHADOW_CORNER_RADIUS + SHADOW_BLUR_RADIUS + 2;
+    m_tileCornerSize = qRound(m_cornerSize * scale);
+
+    const int tileSize = 2 * m_cornerSize + 2;
+    const QSize tilePixelSize = QSize(tileSize, tileSize) * scale;
+
+    // Window with rounded top corners and square bottom ones, in the middle of the tile. Only its
+    // coverage is blurred, the shape is dark enough for the color of the outline not to matter
+    QImage mask(tilePixelSize, QImage::Format_Alpha8);
+    mask.fill(0);
+    {
+        QPainter maskPainter(&mask);
+        maskPainter.scale(scale, scale);
+        maskPainter.setBrush(color);
+        maskPainter.drawRoundedRect(shadowWidth, shadowWidth, tileSize - (2 * shadowWidth), tileSize / 2, SHADOW_CORNER_RADIUS, SHADOW_CORNER_RADIUS);
+        maskPainter.drawRect(shadowWidth, tileSize / 2, tileSize - (2 * shadowWidth), (tileSize / 2) - shadowWidth);
+    }
+    blurAlphaImage(mask, qRound(SHADOW_BLUR_RADIUS * scale));
+
+    m_tile = QImage(tilePixelSize, QImage::Format_ARGB32_Premultiplied);
+    m_tile.fill(QColor(color.red(), color.green(), color.blue()));
+
+    QPainter tilePainter(&m_tile);
+    tilePainter.setCompositionMode(QPainter::CompositionMode_DestinationIn);
+    tilePainter.drawImage(0, 0, mask);
+    tilePainter.setCompositionMode(QPainter::CompositionMode_SourceIn);
+    const int colorInset = qRound(SHADOW_COLOR_INSET * scale);
+    tilePainter.fillRect(m_tile.rect().marginsRemoved(QMargins(colorInset, colorInset, colorInset, colorInset)), QColor(0, 0, 0, 160));
+    tilePainter.end();
+}
+
+const DecorationShadow &DecorationShadow::forColor(const QColor &color, int shadowWidth, qreal scale)
+{
+    // Decorations are only ever painted from the GUI thread. There are only a few
+    // of these, one for each border color and screen scale in use
+    static std::map<std::tuple<QRgb, int, int>, std::unique_ptr<DecorationShadow>> shadows;
+
+    const auto key = std::make_tuple(color.rgba(), shadowWidth, qRound(scale * 100));
+    auto it = shadows.find(key);
+    if (it == shadows.end()) {
+        it = shadows.emplace(key, std::unique_ptr<DecorationShadow>(new DecorationShadow(color, shadowWidth, scale))).first;
+    }
+
+    return *it->second;
+}
+
+void DecorationShadow::paint(QPainter *painter, const QRect &rect) const
+{
+    const int corner = m_cornerSize;
+    const int middleWidth = rect.width() - (2 * corner);
+    const int middleHeight = rect.height() - (2 * corner);
+
+    // Too small to be split into corners and edges
+    if (middleWidth <= 0 || middleHeight <= 0) {
+        painter->drawImage(rect, m_tile);
+        return;
+    }
+
+    const int tileSize = m_tile.width();
+    const int tileCorner = m_tileCornerSize;
+    const int tileMiddle = tileSize - (2 * tileCorner);
+
+    // Corners
+    painter->drawImage(QRect(rect.left(), rect.top(), corner, corner), m_tile, QRect(0, 0, tileCorner, tileCorner));
+    painter->drawImage(QRect(rect.right() - corner + 1, rect.top(), corner, corner), m_tile, QRect(tileSize - tileCorner, 0, tileCorner, tileCorner));
+    painter->drawImage(QRect(rect.left(), rect.bottom() - corner + 1, corner, corner), m_tile, QRect(0, tileSize - tileCorner, tileCorner, tileCorner));
+    painter->drawImage(QRect(rect.right() - corner + 1, rect.bottom() - corner + 1, corner, corner),
+                       m_tile,
+                       QRect(tileSize - tileCorner, tileSize - tileCorner, tileCorner, tileCorner));
+
+    // Edges, stretched from the middle of the tile
+    painter->drawImage(QRect(rect.left() + corner, rect.top(), middleWidth, corner), m_tile, QRect(tileCorner, 0, tileMiddle, tileCorner));
+    painter->drawImage(QRect(rect.left() + corner, rect.bottom() - corner + 1, middleWidth, corner),
+                       m_tile,
+                       QRect(tileCorner, tileSize - tileCorner, tileMiddle, tileCorner));
+    painter->drawImage(QRect(rect.left(), rect.top() + corner, corner, middleHeight), m_tile, QRect(0, tileCorner, tileCorner, tileMiddle));
+    painter->drawImage(QRect(rect.right() - corner + 1, rect.top() + corner, corner, middleHeight),
+                       m_tile,
+                       QRect(tileSize - tileCorner, tileCorner, tileCorner, tileMiddle));
+}
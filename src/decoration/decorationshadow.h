@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2026 The QGnomePlatform contributors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef DECORATIONSHADOW_H
+#define DECORATIONSHADOW_H
+
+#include <QColor>
+#include <QImage>
+
+class QPainter;
+
+// Window shadow rendered once into a small nine-patch tile, shared by all decorations
+// in the process. Corners are drawn as they are and edges are stretched, so painting
+// the shadow costs the same for any window size
+class DecorationShadow
+{
+public:
+    // Shadow cast by a window border of the given color, spreading shadowWidth pixels out
+    static const DecorationShadow &forColor(const QColor &color, int shadowWidth, qreal scale);
+
+    // Paints the shadow of a window whose shadows span the given rect
+    void paint(QPainter *painter, const QRect &rect) const;
+
+private:
+    DecorationShadow(const QColor &color, int shadowWidth, qreal scale);
+    Q_DISABLE_COPY(DecorationShadow)
+
+    // Tile with the corners and a slice of each edge in between
+    QImage m_tile;
+    // Size of a corner, in logical and device pixels
+    int m_cornerSize;
+    int m_tileCornerSize;
+};
+
+#endif // DECORATIONSHADOW_H
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2026 The QGnomePlatform contributors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#include "decorationstyle.h"
+
+#include <map>
+#include <memory>
+#include <utility>
+
+namespace
+{
+struct DecorationColors {
+    QRgb backgroundStart; // Adwaita GtkHeaderBar color
+    QRgb backgroundEnd; // Adwaita GtkHeaderBar color
+    QRgb backgroundInactive;
+    QRgb foregroundInactive;
+};
+
+constexpr DecorationColors lightColors = {0xffdad6d2, 0xffe1dedb, 0xfff6f5f4, 0xff929595};
+constexpr DecorationColors darkColors = {0xff262626, 0xff2b2b2b, 0xff353535, 0xff919190};
+
+int variantIndex(Adwaita::ColorVariant variant)
+{
+    switch (variant) {
+    case Adwaita::ColorVariant::AdwaitaDark:
+        return 1;
+    case Adwaita::ColorVariant::AdwaitaHighcontrast:
+        return 2;
+    case Adwaita::ColorVariant::AdwaitaHighcontrastInverse:
+        return 3;
+    default:
+        return 0;
+    }
+}
+} // namespace
+
+DecorationStyle::DecorationStyle(Adwaita::ColorVariant variant, const QPalette &palette)
+    : m_variant(variant)
+{
+    const bool darkVariant = variant == Adwaita::ColorVariant::AdwaitaDark || variant == Adwaita::ColorVariant::AdwaitaHighcontrastInverse;
+    const DecorationColors &colors = darkVariant ? darkColors : lightColors;
+
+    // TODO: move colors used for decorations to Adwaita-qt
+    m_foregroundColor = palette.color(QPalette::Active, QPalette::WindowText);
+    m_foregroundInactiveColor = QColor::fromRgba(colors.foregroundInactive);
+    m_backgroundColorStart = QColor::fromRgba(colors.backgroundStart);
+    m_backgroundColorEnd = QColor::fromRgba(colors.backgroundEnd);
+    m_backgroundInactiveColor = QColor::fromRgba(colors.backgroundInactive);
+    // Computed once per style, styles are shared by all decorations
+    m_borderColor = darkVariant ? Adwaita::Colors::transparentize(QColor("#1b1b1b"), 0.1) : Adwaita::Colors::transparentize(QColor("black"), 0.77);
+    m_borderInactiveColor = darkVariant ? Adwaita::Colors::transparentize(QColor("#1b1b1b"), 0.1) : Adwaita::Colors::transparentize(QColor("black"), 0.82);
+}
+
+const DecorationStyle &DecorationStyle::forVariant(Adwaita::ColorVariant variant, const QPalette &palette)
+{
+    // Decorations are only ever painted from the GUI thread. Besides the variant, styles depend
+    // only on the text color of the palette, which changes with the accent color or contrast
+    static std::map<std::pair<int, QRgb>, std::unique_ptr<DecorationStyle>> styles;
+
+    const auto key = std::make_pair(variantIndex(variant), palette.color(QPalette::Active, QPalette::WindowText).rgba());
+    auto it = styles.find(key);
+    if (it == styles.end()) {
+        it = styles.emplace(key, std::unique_ptr<DecorationStyle>(new DecorationStyle(variant, palette))).first;
+    }
+
+    return *it->second;
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2026 The QGnomePlatform contributors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+
+#ifndef DECORATIONSTYLE_H
+#define DECORATIONSTYLE_H
+
+#include <QtGlobal>
+
+#if QT_VERSION >= 0x060000
+#include <AdwaitaQt6/adwaitacolors.h>
+#else
+#include <AdwaitaQt/adwaitacolors.h>
+#endif
+
+#include <QColor>
+#include <QPalette>
+
+// Immutable set of colors used to paint the decoration for one color variant,
+// shared by all decorations in the process
+class DecorationStyle
+{
+public:
+    // Styles are shared for the variant and the colors they take from the palette, and live as
+    // long as the process
+    static const DecorationStyle &forVariant(Adwaita::ColorVariant variant, const QPalette &palette);
+
+    Adwaita::ColorVariant variant() const
+    {
+        return m_variant;
+    }
+
+    QColor foregroundColor(bool active) const
+    {
+        return active ? m_foregroundColor : m_foregroundInactiveColor;
+    }
+    QColor backgroundColorStart(bool active) const
+    {
+        return active ? m_backgroundColorStart : m_backgroundInactiveColor;
+    }
+    QColor backgroundColorEnd(bool active) const
+    {
+        return active ? m_backgroundColorEnd : m_backgroundInactiveColor;
+    }
+    QColor borderColor(bool active) const
+    {
+        return active ? m_borderColor : m_borderInactiveColor;
+    }
+
+private:
+    DecorationStyle(Adwaita::ColorVariant variant, const QPalette &palette);
+    Q_DISABLE_COPY(DecorationStyle)
+
+    Adwaita::ColorVariant m_variant;
+
+    QColor m_backgroundColorStart;
+    QColor m_backgroundColorEnd;
+    QColor m_backgroundInactiveColor;
+    QColor m_borderColor;
+    QColor m_borderInactiveColor;
+    QColor m_foregroundColor;
+    QColor m_foregroundInactiveColor;
+};
+
+#endif // DECORATIONSTYLE_H
@@ -41,6 +41,9 @@
 
 #include "qgnomeplatformdecoration.h"
 
+#include "decorationbuttons.h"
+#include "decorationshadow.h"
+#include "decorationstyle.h"
 #include "gnomesettings.h"
 
 #include <QtGui/QColor>
@@ -50,6 +53,7 @@
 #include <QtGui/QPainterPath>
 #include <QtGui/QPalette>
 #include <QtGui/QPixmap>
+#include <QtGui/QScreen>
 
 #include <qpa/qwindowsysteminterface.h>
 
@@ -69,7 +73,8 @@
 #define WINDOW_BORDER_WIDTH 1
 #define TITLEBAR_SEPARATOR_SIZE 0.5
 
-Q_DECL_IMPORT void qt_blurImage(QPainter *p, QImage &blurImage, qreal radius, bool quality, bool alphaOnly, int transposed = 0);
+// Used to pace repaints when the screen doesn't report its refresh rate
+#define DEFAULT_REFRESH_RATE 60
 
 QGnomePlatformDecoration::QGnomePlatformDecoration()
     : m_closeButtonHovered(false)
@@ -82,18 +87,23 @@ QGnomePlatformDecoration::QGnomePlatformDecoration()
     option.setWrapMode(QTextOption::NoWrap);
     m_windowTitle.setTextOption(option);
 
-    connect(&GnomeSettings::getInstance(), &GnomeSettings::themeChanged, this, [this]() {
-        loadConfiguration();
-        forceRepaint();
-    });
-    connect(&GnomeSettings::getInstance(), &GnomeSettings::titlebarChanged, this, [this]() {
-        loadConfiguration();
-        forceRepaint();
-    });
+    m_repaintTimer.setSingleShot(true);
+    m_repaintTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_repaintTimer, &QTimer::timeout, this, &QGnomePlatformDecoration::repaintPending);
+
+    connect(&GnomeSettings::getInstance(), &GnomeSettings::themeChanged, this, &QGnomePlatformDecoration::invalidateConfiguration);
+    connect(&GnomeSettings::getInstance(), &GnomeSettings::titlebarChanged, this, &QGnomePlatformDecoration::invalidateConfiguration);
+
+    GnomeSettings::getInstance().registerInterest(GnomeSettings::DecorationInterest);
 
     loadConfiguration();
 }
 
+QGnomePlatformDecoration::~QGnomePlatformDecoration()
+{
+    GnomeSettings::getInstance().unregisterInterest(GnomeSettings::DecorationInterest);
+}
+
 QRectF QGnomePlatformDecoration::closeButtonRect() const
 {
     if (GnomeSettings::getInstance().titlebarButtonPlacement() == GnomeSettings::getInstance().RightPlacement) {
@@ -195,6 +205,127 @@ QMargins QGnomePlatformDecoration::margins() const
 }
 
 void QGnomePlatformDecoration::paint(QPaintDevice *device)
+{
+    if (m_configurationDirty) {
+        loadConfiguration();
+    }
+
+#ifdef DECORATION_SHADOWS_SUPPORT // Qt 6.2.0+ or patched QtWayland
+    const Qt::WindowStates windowStates = waylandWindow()->windowStates();
+    const bool active = windowStates & Qt::WindowActive;
+    const int tilingStates = waylandWindow()->toplevelWindowTilingStates();
+#else
+    const Qt::WindowStates windowStates = window()->windowStates();
+    const bool active = window()->handle()->isActive();
+    const int tilingStates = 0;
+#endif
+
+    // QtWayland hands over a new image each time, the decoration around the window is kept
+    // in its own images and only the parts which changed since it was last painted are painted again
+    const QRect surfaceRect(QPoint(0, 0), windowContentGeometry().size());
+    const qreal scale = device->devicePixelRatioF();
+    const DecorationState state = {surfaceRect.size(), scale, windowStates, active, tilingStates, m_style};
+    const int buttonStates = currentButtonStates();
+
+    QRegion damage;
+    if (!m_decorationPainted || !(m_paintedState == state)) {
+        const QMargins decorationMargins = margins();
+        const int sideHeight = surfaceRect.height() - decorationMargins.top() - decorationMargins.bottom();
+        m_decorationStrips[0].rect = QRect(0, 0, surfaceRect.width(), decorationMargins.top());
+        m_decorationStrips[1].rect = QRect(0, surfaceRect.height() - decorationMargins.bottom(), surfaceRect.width(), decorationMargins.bottom());
+        m_decorationStrips[2].rect = QRect(0, decorationMargins.top(), decorationMargins.left(), sideHeight);
+        m_decorationStrips[3].rect = QRect(surfaceRect.width() - decorationMargins.right(), decorationMargins.top(), decorationMargins.right(), sideHeight);
+        for (DecorationStrip &strip : m_decorationStrips) {
+            if (strip.rect.isEmpty()) {
+                strip.image = QImage();
+                continue;
+            }
+            strip.image = QImage(strip.rect.size() * scale, QImage::Format_ARGB32_Premultiplied);
+            strip.image.setDevicePixelRatio(scale);
+        }
+        m_decorationPainted = true;
+        damage = surfaceRect;
+    } else {
+        const int changedButtons = buttonStates ^ m_paintedButtonStates;
+        if (changedButtons & (CloseHovered | ClosePressed)) {
+            damage += closeButtonRect().toAlignedRect();
+        }
+        if (changedButtons & (MaximizeHovered | MaximizePressed)) {
+            damage += maximizeButtonRect().toAlignedRect();
+        }
+        if (changedButtons & (MinimizeHovered | MinimizePressed)) {
+            damage += minimizeButtonRect().toAlignedRect();
+        }
+        if (window()->title() != m_windowTitle.text()) {
+            damage += titleRect();
+        }
+    }
+
+    for (DecorationStrip &strip : m_decorationStrips) {
+        const QRegion stripDamage = damage & strip.rect;
+        if (!strip.image.isNull() && !stripDamage.isEmpty()) {
+            renderDecoration(&strip.image, strip.rect.topLeft(), stripDamage);
+        }
+    }
+    m_paintedState = state;
+    m_paintedButtonStates = buttonStates;
+
+    QPainter p(device);
+    p.setCompositionMode(QPainter::CompositionMode_Source);
+    for (const DecorationStrip &strip : m_decorationStrips) {
+        if (!strip.image.isNull()) {
+            p.drawImage(strip.rect.topLeft(), strip.image);
+        }
+    }
+}
+
+QRegion QGnomePlatformDecoration::decorationRegion() const
+{
+    const QRect surfaceRect(QPoint(0, 0), windowContentGeometry().size());
+    return QRegion(surfaceRect).subtracted(surfaceRect.marginsRemoved(margins()));
+}
+
+int QGnomePlatformDecoration::currentButtonStates() const
+{
+    int states = 0;
+    if (m_closeButtonHovered) {
+        states |= CloseHovered;
+    }
+    if (m_clicking == Button::Close) {
+        states |= ClosePressed;
+    }
+    if (m_maximizeButtonHovered) {
+        states |= MaximizeHovered;
+    }
+    if (m_clicking == Button::Maximize || m_clicking == Button::Restore) {
+        states |= MaximizePressed;
+    }
+    if (m_minimizeButtonHovered) {
+        states |= MinimizeHovered;
+    }
+    if (m_clicking == Button::Minimize) {
+        states |= MinimizePressed;
+    }
+    return states;
+}
+
+QRect QGnomePlatformDecoration::titleRect() const
+{
+    const QRect surfaceRect = windowContentGeometry();
+
+    // Space between the buttons and the other side of the titlebar
+    QRect titleBar(margins().left(), margins().bottom(), surfaceRect.width(), margins().top() - margins().bottom());
+    if (GnomeSettings::getInstance().titlebarButtonPlacement() == GnomeSettings::getInstance().RightPlacement) {
+        titleBar.setLeft(margins().left());
+        titleBar.setRight(static_cast<int>(minimizeButtonRect().left()) - 8);
+    } else {
+        titleBar.setLeft(static_cast<int>(minimizeButtonRect().right()) + 8);
+        titleBar.setRight(surfaceRect.width() - margins().right());
+    }
+    return titleBar;
+}
+
+void QGnomePlatformDecoration::renderDecoration(QPaintDevice *device, const QPoint &offset, const QRegion &region)
 {
 #ifdef DECORATION_SHADOWS_SUPPORT // Qt 6.2.0+ or patched QtWayland
     const Qt::WindowStates windowStates = waylandWindow()->windowStates();
@@ -205,10 +336,18 @@ void QGnomePlatformDecoration::paint(QPaintDevice *device)
 #endif
 
     const QRect surfaceRect = windowContentGeometry();
-    const QColor borderColor = active ? m_borderColor : m_borderInactiveColor;
+    const QColor borderColor = m_style->borderColor(active);
 
     QPainter p(device);
     p.setRenderHint(QPainter::Antialiasing);
+    // The device holds only a part of the decoration, starting at the offset
+    p.translate(-offset);
+
+    // Everything is painted again within the region, over a cleared background
+    p.setClipRegion(region);
+    p.setCompositionMode(QPainter::CompositionMode_Source);
+    p.fillRect(region.boundingRect(), Qt::transparent);
+    p.setCompositionMode(QPainter::CompositionMode_SourceOver);
 
 #ifdef DECORATION_SHADOWS_SUPPORT // Qt 6.2.0+ or patched QtWayland
     const bool maximized = windowStates & Qt::WindowMaximized;
@@ -228,105 +367,18 @@ void QGnomePlatformDecoration::paint(QPaintDevice *device)
     // *                              *
     // ********************************
     if (active && !(maximized || tiledBottom || tiledTop || tiledRight || tiledLeft)) {
-        if (m_shadowPixmap.size() != surfaceRect.size()) {
-            QPixmap source = QPixmap(surfaceRect.size());
-            source.fill(Qt::transparent);
-            {
-                QPainter tmpPainter(&source);
-                tmpPainter.setBrush(borderColor);
-                tmpPainter.drawRoundedRect(SHADOWS_WIDTH, // Do not paint over shadows
-                                           SHADOWS_WIDTH, // Do not paint over shadows
-                                           surfaceRect.width() - (2 * SHADOWS_WIDTH), // Full width - shadows
-                                           surfaceRect.height() / 2, // Half of the full height
-                                           8,
-                                           8);
-                tmpPainter.drawRect(SHADOWS_WIDTH, // Do not paint over shadows
-                                    surfaceRect.height() / 2, // Start somewhere in the middle
-                                    surfaceRect.width() - (2 * SHADOWS_WIDTH), // Full width - shadows
-                                    (surfaceRect.height() / 2) - SHADOWS_WIDTH); // Half of the full height - shadows
-                tmpPainter.end();
-            }
-
-            QImage backgroundImage(surfaceRect.size(), QImage::Format_ARGB32_Premultiplied);
-            backgroundImage.fill(0);
-
-            QPainter backgroundPainter(&backgroundImage);
-            backgroundPainter.drawPixmap(QPointF(), source);
-            backgroundPainter.end();
-
-            QImage blurredImage(surfaceRect.size(), QImage::Format_ARGB32_Premultiplied);
-            blurredImage.fill(0);
-            {
-                QPainter blurPainter(&blurredImage);
-                qt_blurImage(&blurPainter, backgroundImage, 12, false, false);
-                blurPainter.end();
-            }
-            backgroundImage = blurredImage;
-
-            backgroundPainter.begin(&backgroundImage);
-            backgroundPainter.setCompositionMode(QPainter::CompositionMode_SourceIn);
-            QRect rect = backgroundImage.rect().marginsRemoved(QMargins(8, 8, 8, 8));
-            backgroundPainter.fillRect(rect, QColor(0, 0, 0, 160));
-            backgroundPainter.end();
-
-            m_shadowPixmap = QPixmap::fromImage(backgroundImage);
-        }
-
-        QRect clips[] = {
-            QRect(0, 0, surfaceRect.width(), margins().top()),
-            QRect(0, margins().top(), margins().left(), surfaceRect.height() - margins().top() - margins().bottom()),
-            QRect(0, surfaceRect.height() - margins().bottom(), surfaceRect.width(), margins().bottom()),
-            QRect(surfaceRect.width() - margins().right(), margins().top(), margins().right(), surfaceRect.height() - margins().top() - margins().bottom())};
-
-        for (int i = 0; i < 4; ++i) {
-            p.save();
-            p.setClipRect(clips[i]);
-            p.drawPixmap(QPoint(), m_shadowPixmap);
-            p.restore();
-        }
-    }
-
-    // Title bar (border) - painted only when the window is not maximized or tiled
-    // ********************************
-    // *------------------------------*
-    // *|                            |*
-    // *------------------------------*
-    // *                              *
-    // *                              *
-    // *                              *
-    // *                              *
-    // *                              *
-    // *                              *
-    // ********************************
-    QPainterPath borderRect;
-    if (!(maximized || tiledLeft || tiledRight)) {
-        borderRect.addRoundedRect(SHADOWS_WIDTH, SHADOWS_WIDTH, surfaceRect.width() - (2 * SHADOWS_WIDTH), margins().top() + 8, 10, 10);
-        p.fillPath(borderRect.simplified(), borderColor);
-    }
+        // Shadows are painted only around the window, not under it
+        const QRect shadowRect(QPoint(0, 0), surfaceRect.size());
+        const QRegion shadowRegion = QRegion(shadowRect).subtracted(shadowRect.marginsRemoved(margins()));
 
-    // Title bar
-    // ********************************
-    // *------------------------------*
-    // *|############################|*
-    // *                              *
-    // *                              *
-    // *                              *
-    // *                              *
-    // *                              *
-    // *                              *
-    // *                              *
-    // ********************************
-    QPainterPath roundedRect;
-    if (maximized || tiledRight || tiledLeft) {
-        roundedRect.addRect(margins().left(), margins().bottom(), surfaceRect.width() - margins().left() - margins().right(), margins().top() + 8);
-    } else {
-        roundedRect.addRoundedRect(margins().left(), margins().bottom(), surfaceRect.width() - margins().left() - margins().right(), margins().top() + 8, 8, 8);
+        p.save();
+        p.setClipRegion(shadowRegion, Qt::IntersectClip);
+        DecorationShadow::forColor(borderColor, SHADOWS_WIDTH, device->devicePixelRatioF()).paint(&p, shadowRect);
+        p.restore();
     }
 
-    QLinearGradient gradient(margins().left(), margins().top() + 6, margins().left(), 1);
-    gradient.setColorAt(0, active ? m_backgroundColorStart : m_backgroundInactiveColor);
-    gradient.setColorAt(1, active ? m_backgroundColorEnd : m_backgroundInactiveColor);
-    p.fillPath(roundedRect.simplified(), gradient);
+    // Title bar with its border and the separator from the window
+    p.drawImage(QPoint(0, 0), titlebarBackground(surfaceRect.width(), active, device->devicePixelRatioF()));
 
     // Border around
     // ********************************
@@ -341,74 +393,37 @@ void QGnomePlatformDecoration::paint(QPaintDevice *device)
     // *------------------------------*
     // ********************************
     if (!maximized) {
-        QPainterPath borderPath;
         // Left
         if (!tiledLeft) {
             // Assume tiled-left also means it will be tiled-top and tiled bottom
-            borderPath.addRect(SHADOWS_WIDTH,
-                               tiledTop || tiledBottom ? 0 : margins().top(),
-                               WINDOW_BORDER_WIDTH,
-                               tiledTop || tiledBottom ? surfaceRect.height() : surfaceRect.height() - margins().top() - SHADOWS_WIDTH - WINDOW_BORDER_WIDTH);
+            p.fillRect(SHADOWS_WIDTH,
+                       tiledTop || tiledBottom ? 0 : margins().top(),
+                       WINDOW_BORDER_WIDTH,
+                       tiledTop || tiledBottom ? surfaceRect.height() : surfaceRect.height() - margins().top() - SHADOWS_WIDTH - WINDOW_BORDER_WIDTH,
+                       borderColor);
         }
         // Bottom
         if (!tiledBottom) {
-            borderPath.addRect(SHADOWS_WIDTH,
-                               surfaceRect.height() - SHADOWS_WIDTH - WINDOW_BORDER_WIDTH,
-                               surfaceRect.width() - (2 * SHADOWS_WIDTH),
-                               WINDOW_BORDER_WIDTH);
+            p.fillRect(SHADOWS_WIDTH,
+                       surfaceRect.height() - SHADOWS_WIDTH - WINDOW_BORDER_WIDTH,
+                       surfaceRect.width() - (2 * SHADOWS_WIDTH),
+                       WINDOW_BORDER_WIDTH,
+                       borderColor);
         }
         // Right
         if (!tiledRight) {
-            borderPath.addRect(surfaceRect.width() - margins().right(),
-                               tiledTop || tiledBottom ? 0 : margins().top(),
-                               WINDOW_BORDER_WIDTH,
-                               tiledTop || tiledBottom ? surfaceRect.height() : surfaceRect.height() - margins().top() - SHADOWS_WIDTH - WINDOW_BORDER_WIDTH);
+            p.fillRect(surfaceRect.width() - margins().right(),
+                       tiledTop || tiledBottom ? 0 : margins().top(),
+                       WINDOW_BORDER_WIDTH,
+                       tiledTop || tiledBottom ? surfaceRect.height() : surfaceRect.height() - margins().top() - SHADOWS_WIDTH - WINDOW_BORDER_WIDTH,
+                       borderColor);
         }
-        p.fillPath(borderPath, borderColor);
     }
 #else
-    // Title bar (border)
-    // ********************************
-    // *------------------------------*
-    // *|                            |*
-    // *------------------------------*
-    // *                              *
-    // *                              *
-    // *                              *
-    // *                              *
-    // *                              *
-    // *                              *
-    // ********************************
-    QPainterPath borderRect;
-    if (!(windowStates & Qt::WindowMaximized)) {
-        borderRect.addRoundedRect(0, 0, surfaceRect.width(), margins().top() + 8, 10, 10);
-        p.fillPath(borderRect.simplified(), borderColor);
-    }
-
-    // Title bar
-    // ********************************
-    // *------------------------------*
-    // *|############################|*
-    // *                              *
-    // *                              *
-    // *                              *
-    // *                              *
-    // *                              *
-    // *                              *
-    // *                              *
-    // ********************************
-    QPainterPath roundedRect;
-    if ((windowStates & Qt::WindowMaximized)) {
-        roundedRect.addRect(0, 0, surfaceRect.width(), margins().top() + 8);
-    } else {
-        roundedRect
-            .addRoundedRect(WINDOW_BORDER_WIDTH, WINDOW_BORDER_WIDTH, surfaceRect.width() - margins().left() - margins().right(), margins().top() + 8, 8, 8);
-    }
+    const bool maximized = windowStates & Qt::WindowMaximized;
 
-    QLinearGradient gradient(margins().left(), margins().top() + 6, margins().left(), 1);
-    gradient.setColorAt(0, active ? m_backgroundColorStart : m_backgroundInactiveColor);
-    gradient.setColorAt(1, active ? m_backgroundColorEnd : m_backgroundInactiveColor);
-    p.fillPath(roundedRect.simplified(), gradient);
+    // Title bar with its border and the separator from the window
+    p.drawImage(QPoint(0, 0), titlebarBackground(surfaceRect.width(), active, device->devicePixelRatioF()));
 
     // Border around
     // ********************************
@@ -422,39 +437,19 @@ void QGnomePlatformDecoration::paint(QPaintDevice *device)
     // *|                            |*
     // *------------------------------*
     // ********************************
-    if (!(windowStates & Qt::WindowMaximized)) {
-        QPainterPath borderPath;
+    if (!maximized) {
         // Left
-        borderPath.addRect(0, margins().top(), margins().left(), surfaceRect.height() - margins().top() - WINDOW_BORDER_WIDTH);
+        p.fillRect(0, margins().top(), margins().left(), surfaceRect.height() - margins().top() - WINDOW_BORDER_WIDTH, borderColor);
         // Bottom
-        borderPath.addRect(0, surfaceRect.height() - WINDOW_BORDER_WIDTH, surfaceRect.width(), WINDOW_BORDER_WIDTH);
+        p.fillRect(0, surfaceRect.height() - WINDOW_BORDER_WIDTH, surfaceRect.width(), WINDOW_BORDER_WIDTH, borderColor);
         // Right
-        borderPath.addRect(surfaceRect.width() - margins().right(),
-                           margins().top(),
-                           WINDOW_BORDER_WIDTH,
-                           surfaceRect.height() - margins().bottom() - margins().top());
-        p.fillPath(borderPath, borderColor);
+        p.fillRect(surfaceRect.width() - margins().right(),
+                   margins().top(),
+                   WINDOW_BORDER_WIDTH,
+                   surfaceRect.height() - margins().bottom() - margins().top(),
+                   borderColor);
     }
 #endif
-    // Border between window and decorations
-    // ********************************
-    // *------------------------------*
-    // *|############################|*
-    // *------------------------------*
-    // *|                            |*
-    // *|                            |*
-    // *|                            |*
-    // *|                            |*
-    // *|                            |*
-    // *------------------------------*
-    // ********************************
-    p.save();
-    p.setPen(borderColor);
-    p.drawLine(QLineF(margins().left(),
-                      margins().top() - TITLEBAR_SEPARATOR_SIZE,
-                      surfaceRect.width() - margins().right(),
-                      margins().top() - TITLEBAR_SEPARATOR_SIZE));
-    p.restore();
 
     // Window title
     // ********************************
@@ -471,24 +466,15 @@ void QGnomePlatformDecoration::paint(QPaintDevice *device)
 
     const QRect top = QRect(margins().left(), margins().bottom(), surfaceRect.width(), margins().top() - margins().bottom());
     const QString windowTitleText = window()->title();
-    if (!windowTitleText.isEmpty()) {
-        if (m_windowTitle.text() != windowTitleText) {
-            m_windowTitle.setText(windowTitleText);
-            m_windowTitle.prepare();
-        }
-
-        QRect titleBar = top;
-        if (GnomeSettings::getInstance().titlebarButtonPlacement() == GnomeSettings::getInstance().RightPlacement) {
-            titleBar.setLeft(margins().left());
-            titleBar.setRight(static_cast<int>(minimizeButtonRect().left()) - 8);
-        } else {
-            titleBar.setLeft(static_cast<int>(minimizeButtonRect().right()) + 8);
-            titleBar.setRight(surfaceRect.width() - margins().right());
-        }
+    if (m_windowTitle.text() != windowTitleText) {
+        m_windowTitle.setText(windowTitleText);
+        m_windowTitle.prepare();
+    }
 
+    if (!windowTitleText.isEmpty()) {
         p.save();
-        p.setClipRect(titleBar);
-        p.setPen(active ? m_foregroundColor : m_foregroundInactiveColor);
+        p.setClipRect(titleRect(), Qt::IntersectClip);
+        p.setPen(m_style->foregroundColor(active));
         QSizeF size = m_windowTitle.size();
         int dx = (static_cast<int>(top.width()) - static_cast<int>(size.width())) / 2;
         int dy = (static_cast<int>(top.height()) - static_cast<int>(size.height())) / 2;
@@ -497,6 +483,8 @@ void QGnomePlatformDecoration::paint(QPaintDevice *device)
         font.setPointSizeF(themeFont->pointSizeF());
         font.setFamily(themeFont->family());
         font.setBold(themeFont->bold());
+        font.setStyleStrategy(themeFont->styleStrategy());
+        font.setHintingPreference(themeFont->hintingPreference());
         p.setFont(font);
         QPoint windowTitlePoint(top.topLeft().x() + dx, top.topLeft().y() + dy);
         p.drawStaticText(windowTitlePoint, m_windowTitle);
@@ -521,6 +509,136 @@ void QGnomePlatformDecoration::paint(QPaintDevice *device)
     }
 }
 
+const QImage &QGnomePlatformDecoration::titlebarBackground(int width, bool active, qreal scale)
+{
+#ifdef DECORATION_SHADOWS_SUPPORT // Qt 6.2.0+ or patched QtWayland
+    const bool maximized = waylandWindow()->windowStates() & Qt::WindowMaximized;
+    const int tilingStates = waylandWindow()->toplevelWindowTilingStates();
+    const bool tiledLeft = tilingStates & QWaylandWindow::WindowTiledLeft;
+    const bool tiledRight = tilingStates & QWaylandWindow::WindowTiledRight;
+#else
+    const bool maximized = window()->windowStates() & Qt::WindowMaximized;
+    const int tilingStates = 0;
+#endif
+
+    // Rendered again only when its size, state or colors change, not for hover or title changes
+    const TitlebarBackgroundKey key = {width, active, maximized, tilingStates, m_style, scale};
+    if (!m_titlebarBackground.isNull() && m_titlebarBackgroundKey == key) {
+        return m_titlebarBackground;
+    }
+    m_titlebarBackgroundKey = key;
+
+    const QColor borderColor = m_style->borderColor(active);
+
+    // Tall enough for the rounded bottom corners of the paths, which are covered by the window anyway
+    const int height = margins().top() + SHADOWS_WIDTH + WINDOW_BORDER_WIDTH + 8;
+    m_titlebarBackground = QImage(QSize(width, height) * scale, QImage::Format_ARGB32_Premultiplied);
+    m_titlebarBackground.setDevicePixelRatio(scale);
+    m_titlebarBackground.fill(Qt::transparent);
+
+    QPainter p(&m_titlebarBackground);
+    p.setRenderHint(QPainter::Antialiasing);
+
+#ifdef DECORATION_SHADOWS_SUPPORT // Qt 6.2.0+ or patched QtWayland
+    // Title bar (border) - painted only when the window is not maximized or tiled
+    // ********************************
+    // *------------------------------*
+    // *|                            |*
+    // *------------------------------*
+    // *                              *
+    // *                              *
+    // *                              *
+    // *                              *
+    // *                              *
+    // *                              *
+    // ********************************
+    QPainterPath borderRect;
+    if (!(maximized || tiledLeft || tiledRight)) {
+        borderRect.addRoundedRect(SHADOWS_WIDTH, SHADOWS_WIDTH, width - (2 * SHADOWS_WIDTH), margins().top() + 8, 10, 10);
+        p.fillPath(borderRect.simplified(), borderColor);
+    }
+
+    // Title bar
+    // ********************************
+    // *------------------------------*
+    // *|############################|*
+    // *                              *
+    // *                              *
+    // *                              *
+    // *                              *
+    // *                              *
+    // *                              *
+    // *                              *
+    // ********************************
+    QPainterPath roundedRect;
+    if (maximized || tiledRight || tiledLeft) {
+        roundedRect.addRect(margins().left(), margins().bottom(), width - margins().left() - margins().right(), margins().top() + 8);
+    } else {
+        roundedRect.addRoundedRect(margins().left(), margins().bottom(), width - margins().left() - margins().right(), margins().top() + 8, 8, 8);
+    }
+#else
+    // Title bar (border)
+    // ********************************
+    // *------------------------------*
+    // *|                            |*
+    // *------------------------------*
+    // *                              *
+    // *                              *
+    // *                              *
+    // *                              *
+    // *                              *
+    // *                              *
+    // ********************************
+    QPainterPath borderRect;
+    if (!maximized) {
+        borderRect.addRoundedRect(0, 0, width, margins().top() + 8, 10, 10);
+        p.fillPath(borderRect.simplified(), borderColor);
+    }
+
+    // Title bar
+    // ********************************
+    // *------------------------------*
+    // *|############################|*
+    // *                              *
+    // *                              *
+    // *                              *
+    // *                              *
+    // *                              *
+    // *                              *
+    // *                              *
+    // ********************************
+    QPainterPath roundedRect;
+    if (maximized) {
+        roundedRect.addRect(0, 0, width, margins().top() + 8);
+    } else {
+        roundedRect.addRoundedRect(WINDOW_BORDER_WIDTH, WINDOW_BORDER_WIDTH, width - margins().left() - margins().right(), margins().top() + 8, 8, 8);
+    }
+#endif
+
+    QLinearGradient gradient(margins().left(), margins().top() + 6, margins().left(), 1);
+    gradient.setColorAt(0, m_style->backgroundColorStart(active));
+    gradient.setColorAt(1, m_style->backgroundColorEnd(active));
+    p.fillPath(roundedRect.simplified(), gradient);
+
+    // Border between window and decorations
+    // ********************************
+    // *------------------------------*
+    // *|############################|*
+    // *------------------------------*
+    // *|                            |*
+    // *|                            |*
+    // *|                            |*
+    // *|                            |*
+    // *|                            |*
+    // *------------------------------*
+    // ********************************
+    p.setPen(borderColor);
+    p.drawLine(QLineF(margins().left(), margins().top() - TITLEBAR_SEPARATOR_SIZE, width - margins().right(), margins().top() - TITLEBAR_SEPARATOR_SIZE));
+    p.end();
+
+    return m_titlebarBackground;
+}
+
 bool QGnomePlatformDecoration::clickButton(Qt::MouseButtons b, Button btn)
 {
     if (isLeftClicked(b)) {
@@ -642,35 +760,74 @@ QRect QGnomePlatformDecoration::windowContentGeometry() const
 
 void QGnomePlatformDecoration::loadConfiguration()
 {
-    // Colors
-    // TODO: move colors used for decorations to Adwaita-qt
-    const bool darkVariant = GnomeSettings::getInstance().useGtkThemeDarkVariant();
-    const bool highContrastVariant = GnomeSettings::getInstance().useGtkThemeHighContrastVariant();
-
-    m_adwaitaVariant = darkVariant ? highContrastVariant ? Adwaita::ColorVariant::AdwaitaHighcontrastInverse : Adwaita::ColorVariant::AdwaitaDark
-        : highContrastVariant      ? Adwaita::ColorVariant::AdwaitaHighcontrast
-                                   : Adwaita::ColorVariant::Adwaita;
-
-    const QPalette &palette(Adwaita::Colors::palette(m_adwaitaVariant));
-
-    m_foregroundColor = palette.color(QPalette::Active, QPalette::WindowText);
-    m_foregroundInactiveColor = palette.color(QPalette::Inactive, QPalette::WindowText);
-    m_backgroundColorStart = darkVariant ? QColor("#262626") : QColor("#dad6d2"); // Adwaita GtkHeaderBar color
-    m_backgroundColorEnd = darkVariant ? QColor("#2b2b2b") : QColor("#e1dedb"); // Adwaita GtkHeaderBar color
-    m_foregroundInactiveColor = darkVariant ? QColor("#919190") : QColor("#929595");
-    m_backgroundInactiveColor = darkVariant ? QColor("#353535") : QColor("#f6f5f4");
-    m_borderColor = darkVariant ? Adwaita::Colors::transparentize(QColor("#1b1b1b"), 0.1) : Adwaita::Colors::transparentize(QColor("black"), 0.77);
-    m_borderInactiveColor = darkVariant ? Adwaita::Colors::transparentize(QColor("#1b1b1b"), 0.1) : Adwaita::Colors::transparentize(QColor("black"), 0.82);
+    // Reuse the palette already built for the application
+    const GnomeSettings &settings = GnomeSettings::getInstance();
+    m_style = &DecorationStyle::forVariant(settings.colorVariant(), *settings.palette());
+    m_configurationDirty = false;
+
+    // Fonts or buttons might have changed as well, everything is painted again
+    m_decorationPainted = false;
+}
+
+void QGnomePlatformDecoration::invalidateConfiguration()
+{
+    m_configurationDirty = true;
+
+    // Windows which are not visible right now only get marked as dirty and pick
+    // up the new configuration from paint() once they are exposed again
+#ifdef DECORATION_SHADOWS_SUPPORT // Qt 6.2.0+ or patched QtWayland
+    const bool minimized = waylandWindow()->windowStates() & Qt::WindowMinimized;
+#else
+    const bool minimized = window()->windowStates() & Qt::WindowMinimized;
+#endif
+    if (!waylandWindow()->isExposed() || minimized) {
+        update();
+        return;
+    }
+
+    forceRepaint();
 }
 
 void QGnomePlatformDecoration::forceRepaint()
 {
+    m_repaintAllPending = true;
+    scheduleRepaint();
+}
+
+void QGnomePlatformDecoration::repaintRegion(const QRegion &region)
+{
+    m_pendingRepaint += region;
+    scheduleRepaint();
+}
+
+void QGnomePlatformDecoration::scheduleRepaint()
+{
+    // Requests coming faster than the screen refreshes are merged into a single repaint,
+    // the first one after a while is handled right away
+    if (m_repaintTimer.isActive()) {
+        return;
+    }
+
+    const qreal refreshRate = window()->screen() ? window()->screen()->refreshRate() : 0;
+    const int frameInterval = qRound(1000 / (refreshRate > 1 ? refreshRate : DEFAULT_REFRESH_RATE));
+    const qint64 sinceLastRepaint = m_lastRepaint.isValid() ? m_lastRepaint.elapsed() : frameInterval;
+    m_repaintTimer.start(static_cast<int>(qMax<qint64>(0, frameInterval - sinceLastRepaint)));
+}
+
+void QGnomePlatformDecoration::repaintPending()
+{
+    // Only the decoration is flushed, the window content did not change
+    const QRegion region = m_repaintAllPending ? decorationRegion() : m_pendingRepaint & decorationRegion();
+    m_pendingRepaint = QRegion();
+    m_repaintAllPending = false;
+    m_lastRepaint.start();
+
     // Set dirty flag
     waylandWindow()->decoration()->update();
-    // Force re-paint
+    // Force re-paint, the backing store expects the region relative to the window
     // NOTE: not sure it's correct, but it's the only way to make it work
     if (waylandWindow()->backingStore()) {
-        waylandWindow()->backingStore()->flush(window(), QRegion(), QPoint());
+        waylandWindow()->backingStore()->flush(window(), region.translated(-margins().left(), -margins().top()), QPoint());
     }
 }
 
@@ -788,29 +945,13 @@ void QGnomePlatformDecoration::processMouseRight(QWaylandInputDevice *inputDevic
 void QGnomePlatformDecoration::renderButton(QPainter *painter, const QRectF &rect, Adwaita::ButtonType button, bool renderFrame, bool sunken)
 {
 #ifdef DECORATION_SHADOWS_SUPPORT // Qt 6.2.0+ or patched QtWayland
-    const Qt::WindowStates windowStates = waylandWindow()->windowStates();
-    const bool active = windowStates & Qt::WindowActive;
+    const bool active = waylandWindow()->windowStates() & Qt::WindowActive;
 #else
-    const Qt::WindowStates windowStates = window()->windowStates();
     const bool active = window()->handle()->isActive();
 #endif
 
-    Adwaita::StyleOptions decorationButtonStyle(painter, QRect());
-    decorationButtonStyle.setColor(active ? m_foregroundColor : m_foregroundInactiveColor);
-
-    if (renderFrame) {
-        QRect buttonRect(static_cast<int>(rect.x()), static_cast<int>(rect.y()), BUTTON_WIDTH, BUTTON_WIDTH);
-        Adwaita::StyleOptions styleOptions(painter, buttonRect);
-        styleOptions.setMouseOver(true);
-        styleOptions.setSunken(sunken);
-        styleOptions.setColorVariant(m_adwaitaVariant);
-        styleOptions.setColor(Adwaita::Colors::buttonBackgroundColor(styleOptions));
-        styleOptions.setOutlineColor(Adwaita::Colors::buttonOutlineColor(styleOptions));
-        Adwaita::Renderer::renderFlatRoundedButtonFrame(styleOptions);
-    }
-    decorationButtonStyle.setRect(
-        QRect(static_cast<int>(rect.x()) + (BUTTON_WIDTH / 4), static_cast<int>(rect.y()) + (BUTTON_WIDTH / 4), BUTTON_WIDTH / 2, BUTTON_WIDTH / 2));
-    Adwaita::Renderer::renderDecorationButton(decorationButtonStyle, button);
+    const QPoint position(static_cast<int>(rect.x()), static_cast<int>(rect.y()));
+    DecorationButtons::forStyle(*m_style, BUTTON_WIDTH, painter->device()->devicePixelRatioF()).paint(painter, position, button, renderFrame, sunken, active);
 }
 
 bool QGnomePlatformDecoration::updateButtonHoverState(Button hoveredButton)
@@ -823,9 +964,20 @@ bool QGnomePlatformDecoration::updateButtonHoverState(Button hoveredButton)
     m_maximizeButtonHovered = hoveredButton == Button::Maximize;
     m_minimizeButtonHovered = hoveredButton == Button::Minimize;
 
-    if (m_closeButtonHovered != currentCloseButtonState || m_maximizeButtonHovered != currentMaximizeButtonState
-        || m_minimizeButtonHovered != currentMinimizeButtonState) {
-        forceRepaint();
+    // Only the buttons which changed are painted and sent to the compositor again
+    QRegion changedButtons;
+    if (m_closeButtonHovered != currentCloseButtonState) {
+        changedButtons += closeButtonRect().toAlignedRect();
+    }
+    if (m_maximizeButtonHovered != currentMaximizeButtonState) {
+        changedButtons += maximizeButtonRect().toAlignedRect();
+    }
+    if (m_minimizeButtonHovered != currentMinimizeButtonState) {
+        changedButtons += minimizeButtonRect().toAlignedRect();
+    }
+
+    if (!changedButtons.isEmpty()) {
+        repaintRegion(changedButtons);
         return true;
     }
 
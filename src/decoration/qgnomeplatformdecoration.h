@@ -33,17 +33,32 @@
 #include <QtGlobal>
 
 #include <QDateTime>
-#include <QPixmap>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QStaticText>
+#include <QTimer>
 
 using namespace QtWaylandClient;
 
+class DecorationStyle;
+
 enum Button { None, Close, Maximize, Minimize, Restore };
 
+// Hover and press state of the buttons, as last painted
+enum ButtonStateFlag {
+    CloseHovered = 0x1,
+    ClosePressed = 0x2,
+    MaximizeHovered = 0x4,
+    MaximizePressed = 0x8,
+    MinimizeHovered = 0x10,
+    MinimizePressed = 0x20,
+};
+
 class QGnomePlatformDecoration : public QWaylandAbstractDecoration
 {
 public:
     QGnomePlatformDecoration();
-    virtual ~QGnomePlatformDecoration() override = default;
+    virtual ~QGnomePlatformDecoration() override;
 
 protected:
 #ifdef DECORATION_SHADOWS_SUPPORT // Qt 6.2.0+ or patched QtWayland
@@ -63,8 +78,16 @@ protected:
 
 private:
     QRect windowContentGeometry() const;
+    QRect titleRect() const;
+    int currentButtonStates() const;
+    QRegion decorationRegion() const;
 
+    void renderDecoration(QPaintDevice *device, const QPoint &offset, const QRegion &region);
     void forceRepaint();
+    void repaintRegion(const QRegion &region);
+    void scheduleRepaint();
+    void repaintPending();
+    void invalidateConfiguration();
     void loadConfiguration();
 
     void processMouseTop(QWaylandInputDevice *inputDevice, const QPointF &local, Qt::MouseButtons b, Qt::KeyboardModifiers mods);
@@ -72,6 +95,7 @@ private:
     void processMouseLeft(QWaylandInputDevice *inputDevice, const QPointF &local, Qt::MouseButtons b, Qt::KeyboardModifiers mods);
     void processMouseRight(QWaylandInputDevice *inputDevice, const QPointF &local, Qt::MouseButtons b, Qt::KeyboardModifiers mods);
     void renderButton(QPainter *painter, const QRectF &rect, Adwaita::ButtonType button, bool renderFrame, bool sunken);
+    const QImage &titlebarBackground(int width, bool active, qreal scale);
 
     bool clickButton(Qt::MouseButtons b, Button btn);
     bool doubleClickButton(Qt::MouseButtons b, const QPointF &local, const QDateTime &currentTime);
@@ -82,13 +106,57 @@ private:
     QRectF minimizeButtonRect() const;
 
     // Colors
-    QColor m_backgroundColorStart;
-    QColor m_backgroundColorEnd;
-    QColor m_backgroundInactiveColor;
-    QColor m_borderColor;
-    QColor m_borderInactiveColor;
-    QColor m_foregroundColor;
-    QColor m_foregroundInactiveColor;
+    const DecorationStyle *m_style = nullptr;
+
+    // Titlebar background, together with everything it was rendered for
+    struct TitlebarBackgroundKey {
+        int width = 0;
+        bool active = false;
+        bool maximized = false;
+        int tilingStates = 0;
+        const DecorationStyle *style = nullptr;
+        qreal scale = 1.0;
+
+        bool operator==(const TitlebarBackgroundKey &other) const
+        {
+            return width == other.width && active == other.active && maximized == other.maximized && tilingStates == other.tilingStates
+                && style == other.style && qFuzzyCompare(scale, other.scale);
+        }
+    };
+    TitlebarBackgroundKey m_titlebarBackgroundKey;
+    QImage m_titlebarBackground;
+
+    // Whole decoration, together with the state of the window it was painted for
+    struct DecorationState {
+        QSize size;
+        qreal scale = 1.0;
+        Qt::WindowStates windowStates;
+        bool active = false;
+        int tilingStates = 0;
+        const DecorationStyle *style = nullptr;
+
+        bool operator==(const DecorationState &other) const
+        {
+            return size == other.size && qFuzzyCompare(scale, other.scale) && windowStates == other.windowStates && active == other.active
+                && tilingStates == other.tilingStates && style == other.style;
+        }
+    };
+    DecorationState m_paintedState;
+    int m_paintedButtonStates = 0;
+    bool m_decorationPainted = false;
+
+    // Last painted decoration, only the parts around the window are kept: top, bottom, left and right
+    struct DecorationStrip {
+        QRect rect;
+        QImage image;
+    };
+    DecorationStrip m_decorationStrips[4];
+
+    // Repaints waiting for the next frame
+    QTimer m_repaintTimer;
+    QElapsedTimer m_lastRepaint;
+    QRegion m_pendingRepaint;
+    bool m_repaintAllPending = false;
 
     // Buttons
     bool m_closeButtonHovered;
@@ -103,10 +171,7 @@ private:
     QStaticText m_windowTitle;
     Button m_clicking = None;
 
-    // Shadows
-    QPixmap m_shadowPixmap;
-
-    Adwaita::ColorVariant m_adwaitaVariant;
+    bool m_configurationDirty = true;
 };
 
 #endif // QGNOMEPLATFORMDECORATION_H
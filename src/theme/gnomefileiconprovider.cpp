@@ -0,0 +1,322 @@
+/*
+ * Copyright (C) 2026 The QGnomePlatform contributors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#include "gnomefileiconprovider.h"
+
+#include <QFile>
+#include <QPainter>
+#include <QWidget>
+
+#include <private/qiconloader_p.h>
+
+#undef signals
+#include <gio/gio.h>
+#define signals Q_SIGNALS
+
+// Number of files we remember the content type resolved from their content for
+#define CONTENT_TYPE_CACHE_SIZE 16384
+// Amount of data GIO needs to recognize a file by its content
+#define CONTENT_SNIFF_SIZE 4096
+
+Q_GLOBAL_STATIC(GnomeFileIconProvider, gnomeFileIconProviderGlobal)
+
+GnomeFileIconProvider::GnomeFileIconProvider(QObject *parent)
+    : QObject(parent)
+    , m_contentTypes(CONTENT_TYPE_CACHE_SIZE)
+{
+    // A single thread is enough, reading is limited by the disk anyway
+    m_threadPool.setMaxThreadCount(1);
+}
+
+GnomeFileIconProvider::~GnomeFileIconProvider()
+{
+    m_threadPool.clear();
+    m_threadPool.waitForDone();
+}
+
+GnomeFileIconProvider &GnomeFileIconProvider::getInstance()
+{
+    return *gnomeFileIconProviderGlobal;
+}
+
+static QString guessContentType(const QString &fileName, const QByteArray &data, bool *uncertain)
+{
+    gboolean guessUncertain = false;
+    gchar *type = g_content_type_guess(QFile::encodeName(fileName).constData(),
+                                       data.isEmpty() ? nullptr : reinterpret_cast<const guchar *>(data.constData()),
+                                       data.size(),
+                                       &guessUncertain);
+    const QString contentType = QString::fromUtf8(type);
+    g_free(type);
+
+    if (uncertain) {
+        *uncertain = guessUncertain;
+    }
+    return contentType;
+}
+
+static QString sniffContentType(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QString();
+    }
+
+    return guessContentType(filePath, file.read(CONTENT_SNIFF_SIZE), nullptr);
+}
+
+QString GnomeFileIconProvider::contentType(const QFileInfo &fileInfo, bool *pending, QWidget *requester)
+{
+    if (pending) {
+        *pending = false;
+    }
+
+    if (fileInfo.isDir()) {
+        return QStringLiteral("inode/directory");
+    }
+
+    const QString filePath = fileInfo.absoluteFilePath();
+    {
+        QMutexLocker locker(&m_mutex);
+        if (QString *contentType = m_contentTypes.object(filePath)) {
+            return *contentType;
+        }
+    }
+
+    // Guessing from the file name alone doesn't touch the disk
+    bool uncertain = false;
+    const QString contentType = guessContentType(fileInfo.fileName(), QByteArray(), &uncertain);
+
+    if (uncertain && fileInfo.isFile()) {
+        resolveContentType(filePath, requester);
+        if (pending) {
+            *pending = true;
+        }
+    }
+
+    return contentType;
+}
+
+QString GnomeFileIconProvider::resolvedContentType(const QFileInfo &fileInfo)
+{
+    if (fileInfo.isDir()) {
+        return QStringLiteral("inode/directory");
+    }
+
+    const QString filePath = fileInfo.absoluteFilePath();
+    {
+        QMutexLocker locker(&m_mutex);
+        if (QString *contentType = m_contentTypes.object(filePath)) {
+            return *contentType;
+        }
+    }
+
+    bool uncertain = false;
+    const QString contentType = guessContentType(fileInfo.fileName(), QByteArray(), &uncertain);
+    if (!uncertain || !fileInfo.isFile()) {
+        return contentType;
+    }
+
+    const QString sniffedType = sniffContentType(filePath);
+    if (sniffedType.isEmpty()) {
+        return contentType;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_contentTypes.insert(filePath, new QString(sniffedType));
+    return sniffedType;
+}
+
+void GnomeFileIconProvider::resolveContentType(const QString &filePath, QWidget *requester)
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_pendingFiles.find(filePath);
+    if (it != m_pendingFiles.end()) {
+        if (requester && !it->contains(requester)) {
+            it->append(requester);
+        }
+        return;
+    }
+    m_pendingFiles.insert(filePath, requester ? QVector<QPointer<QWidget>>{requester} : QVector<QPointer<QWidget>>());
+
+    m_threadPool.start([this, filePath]() {
+        QString contentType;
+        {
+            QMutexLocker locker(&m_mutex);
+            if (QString *cachedType = m_contentTypes.object(filePath)) {
+                contentType = *cachedType;
+            }
+        }
+        if (contentType.isEmpty()) {
+            contentType = sniffContentType(filePath);
+        }
+
+        QMutexLocker locker(&m_mutex);
+        const QVector<QPointer<QWidget>> requesters = m_pendingFiles.take(filePath);
+        if (contentType.isEmpty()) {
+            return;
+        }
+
+        m_contentTypes.insert(filePath, new QString(contentType));
+        m_resolvedRequesters << requesters;
+        // Results of a whole directory are delivered at once
+        if (!m_updateScheduled) {
+            m_updateScheduled = true;
+            QMetaObject::invokeMethod(this, &GnomeFileIconProvider::onContentTypesResolved, Qt::QueuedConnection);
+        }
+    });
+}
+
+void GnomeFileIconProvider::onContentTypesResolved()
+{
+    QVector<QPointer<QWidget>> requesters;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_updateScheduled = false;
+        requesters.swap(m_resolvedRequesters);
+    }
+
+    m_generation++;
+
+    // Views don't know that icons of their files changed, repaint those which painted them
+    QSet<QWidget *> updatedWidgets;
+    for (const QPointer<QWidget> &requester : qAsConst(requesters)) {
+        QWidget *widget = requester.data();
+        if (widget && !updatedWidgets.contains(widget)) {
+            updatedWidgets.insert(widget);
+            widget->update();
+        }
+    }
+}
+
+QIcon GnomeFileIconProvider::icon(const QString &contentType, bool isDir)
+{
+    const int themeKey = QIconLoader::instance()->themeKey();
+    if (themeKey != m_themeKey) {
+        m_themeKey = themeKey;
+        m_icons.clear();
+    }
+
+    auto it = m_icons.constFind(contentType);
+    if (it != m_icons.constEnd()) {
+        return *it;
+    }
+
+    QIcon icon;
+    GIcon *gicon = g_content_type_get_icon(contentType.toUtf8().constData());
+    if (G_IS_THEMED_ICON(gicon)) {
+        // Names go from the most specific to generic ones, e.g. "text-x-csrc", "text-x-generic"
+        const gchar *const *names = g_themed_icon_get_names(G_THEMED_ICON(gicon));
+        for (int i = 0; names && names[i] && icon.isNull(); i++) {
+            icon = QIcon::fromTheme(QString::fromUtf8(names[i]));
+        }
+    }
+    g_object_unref(gicon);
+
+    if (icon.isNull()) {
+        icon = QIcon::fromTheme(isDir ? QStringLiteral("folder") : QStringLiteral("text-x-generic"));
+    }
+
+    m_icons.insert(contentType, icon);
+    return icon;
+}
+
+GnomeFileIconEngine::GnomeFileIconEngine(const QFileInfo &fileInfo, const QString &contentType)
+    : m_fileInfo(fileInfo)
+    , m_contentType(contentType)
+{
+}
+
+const QIcon &GnomeFileIconEngine::icon(QWidget *requester)
+{
+    GnomeFileIconProvider &provider = GnomeFileIconProvider::getInstance();
+    const int themeKey = QIconLoader::instance()->themeKey();
+    // Asking again registers the requester, views may have asked for the size before painting
+    const bool newRequester = m_pending && requester && m_requester != requester;
+    if (m_generation < 0 || m_themeKey != themeKey || (m_pending && m_generation != provider.generation()) || newRequester) {
+        m_generation = provider.generation();
+        m_themeKey = themeKey;
+        if (requester) {
+            m_requester = requester;
+        }
+        const QString contentType = m_contentType.isEmpty() ? provider.contentType(m_fileInfo, &m_pending, requester) : m_contentType;
+        m_icon = provider.icon(contentType, m_fileInfo.isDir());
+    }
+
+    return m_icon;
+}
+
+void GnomeFileIconEngine::paint(QPainter *painter, const QRect &rect, QIcon::Mode mode, QIcon::State state)
+{
+    // Views paint their items on a widget, which gets repainted once the content type is known
+    QWidget *requester = painter->device()->devType() == QInternal::Widget ? static_cast<QWidget *>(painter->device()) : nullptr;
+    icon(requester).paint(painter, rect, Qt::AlignCenter, mode, state);
+}
+
+QSize GnomeFileIconEngine::actualSize(const QSize &size, QIcon::Mode mode, QIcon::State state)
+{
+    return icon().actualSize(size, mode, state);
+}
+
+QPixmap GnomeFileIconEngine::pixmap(const QSize &size, QIcon::Mode mode, QIcon::State state)
+{
+#if QT_VERSION >= 0x060000
+    return icon().pixmap(size, 1.0, mode, state);
+#else
+    return icon().pixmap(size, mode, state);
+#endif
+}
+
+QString GnomeFileIconEngine::key() const
+{
+    return QStringLiteral("GnomeFileIconEngine");
+}
+
+QIconEngine *GnomeFileIconEngine::clone() const
+{
+    return new GnomeFileIconEngine(m_fileInfo, m_contentType);
+}
+
+#if QT_VERSION >= 0x060000
+QList<QSize> GnomeFileIconEngine::availableSizes(QIcon::Mode mode, QIcon::State state)
+{
+    return icon().availableSizes(mode, state);
+}
+
+QString GnomeFileIconEngine::iconName()
+{
+    return icon().name();
+}
+#else
+void GnomeFileIconEngine::virtual_hook(int id, void *data)
+{
+    switch (id) {
+    case QIconEngine::AvailableSizesHook: {
+        QIconEngine::AvailableSizesArgument &argument = *reinterpret_cast<QIconEngine::AvailableSizesArgument *>(data);
+        argument.sizes = icon().availableSizes(argument.mode, argument.state);
+        break;
+    }
+    case QIconEngine::IconNameHook:
+        *reinterpret_cast<QString *>(data) = icon().name();
+        break;
+    default:
+        QIconEngine::virtual_hook(id, data);
+    }
+}
+#endif
@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2026 The QGnomePlatform contributors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#ifndef GNOME_FILE_ICON_PROVIDER_H
+#define GNOME_FILE_ICON_PROVIDER_H
+
+#include <QCache>
+#include <QFileInfo>
+#include <QHash>
+#include <QIcon>
+#include <QIconEngine>
+#include <QMutex>
+#include <QObject>
+#include <QPointer>
+#include <QSet>
+#include <QThreadPool>
+#include <QVector>
+
+class QWidget;
+
+// Provides icons of files based on their GIO content type
+class GnomeFileIconProvider : public QObject
+{
+    Q_OBJECT
+public:
+    explicit GnomeFileIconProvider(QObject *parent = nullptr);
+    ~GnomeFileIconProvider();
+
+    static GnomeFileIconProvider &getInstance();
+
+    // Icon for a content type, cached per content type until the icon theme changes. Icons
+    // are loaded through QIcon::fromTheme(), so this is used only from the GUI thread
+    QIcon icon(const QString &contentType, bool isDir);
+
+    // Content type guessed from the file name, which never blocks. When the name is not enough,
+    // the file content is checked in background and the requester gets repainted once it's done,
+    // until then pending is set
+    QString contentType(const QFileInfo &fileInfo, bool *pending = nullptr, QWidget *requester = nullptr);
+
+    // Content type checked from the file content when the name is not enough, for threads
+    // which may wait for the disk
+    QString resolvedContentType(const QFileInfo &fileInfo);
+
+    // Changes whenever content types of some files got resolved, used only from the GUI thread
+    inline int generation() const
+    {
+        return m_generation;
+    }
+
+private Q_SLOTS:
+    void onContentTypesResolved();
+
+private:
+    void resolveContentType(const QString &filePath, QWidget *requester);
+
+    QMutex m_mutex;
+    // Content types of files resolved from their content, by file path
+    QCache<QString, QString> m_contentTypes;
+    // Views waiting for content types of their files
+    QHash<QString, QVector<QPointer<QWidget>>> m_pendingFiles;
+    QVector<QPointer<QWidget>> m_resolvedRequesters;
+    bool m_updateScheduled = false;
+    QThreadPool m_threadPool;
+    int m_generation = 0;
+
+    // Icon loader key the icons were looked up with
+    int m_themeKey = -1;
+    QHash<QString, QIcon> m_icons;
+};
+
+// File icons are resolved only when they are painted, views create them for all their files
+class GnomeFileIconEngine : public QIconEngine
+{
+public:
+    // The content type is resolved on first use, unless it's already known
+    explicit GnomeFileIconEngine(const QFileInfo &fileInfo, const QString &contentType = QString());
+
+    void paint(QPainter *painter, const QRect &rect, QIcon::Mode mode, QIcon::State state) override;
+    QSize actualSize(const QSize &size, QIcon::Mode mode, QIcon::State state) override;
+    QPixmap pixmap(const QSize &size, QIcon::Mode mode, QIcon::State state) override;
+    QString key() const override;
+    QIconEngine *clone() const override;
+
+#if QT_VERSION >= 0x060000
+    QList<QSize> availableSizes(QIcon::Mode mode = QIcon::Normal, QIcon::State state = QIcon::Off) override;
+    QString iconName() override;
+#else
+    void virtual_hook(int id, void *data) override;
+#endif
+
+private:
+    const QIcon &icon(QWidget *requester = nullptr);
+
+    QFileInfo m_fileInfo;
+    QString m_contentType;
+    // Icon of the content type resolved so far, looked up again only once new results come in
+    // or the icon theme changes
+    QIcon m_icon;
+    bool m_pending = false;
+    int m_generation = -1;
+    int m_themeKey = -1;
+    QPointer<QWidget> m_requester;
+};
+
+#endif // GNOME_FILE_ICON_PROVIDER_H
@@ -0,0 +1,592 @@
+/*
+ * Copyright (C) 2026 The QGnomePlatform contributors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#include "gnomeiconengine.h"
+#include "gtkiconcache.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFileInfo>
+#include <QGuiApplication>
+#include <QHash>
+#include <QImageReader>
+#include <QPainter>
+#include <QPixmapCache>
+#include <QSet>
+#include <QSettings>
+#include <QtMath>
+
+#include <private/qguiapplication_p.h>
+#include <private/qiconloader_p.h>
+
+#include <climits>
+#include <map>
+#include <memory>
+#include <vector>
+
+// Size range of icons found outside of themes, which are not described by any index.theme
+#define UNTHEMED_ICON_MAX_SIZE 1024
+
+class GnomeIconTheme
+{
+public:
+    GnomeIconTheme(const QString &name, const QStringList &searchPaths);
+
+    bool isValid() const
+    {
+        return !m_contentDirectories.empty();
+    }
+
+    QStringList parents() const
+    {
+        return m_parents;
+    }
+
+    QVector<GnomeIconEntry> lookup(const QString &iconName) const;
+
+private:
+    Q_DISABLE_COPY(GnomeIconTheme)
+
+    // Directory of the theme in one of the search paths
+    struct ContentDirectory {
+        QString path;
+        std::unique_ptr<GtkIconCache> cache;
+        // Maps directories of the cache to m_directories
+        QVector<int> cacheDirectories;
+        // Icons found by scanning the directory, used only when there is no valid cache
+        QHash<QString, QVector<GtkIconCache::Image>> scannedIcons;
+    };
+
+    void scanIcons(ContentDirectory &content) const;
+
+    QVector<GnomeIconDirectory> m_directories;
+    QStringList m_parents;
+    std::vector<ContentDirectory> m_contentDirectories;
+};
+
+class GnomeIconLoader
+{
+public:
+    // Key of Qt's icon loader, which changes with the icon theme or its search paths. Loaded
+    // themes are dropped whenever it does
+    int themeKey();
+
+    QVector<GnomeIconEntry> lookup(const QString &iconName);
+
+private:
+    const GnomeIconTheme *theme(const QString &name);
+    bool lookupInTheme(const QString &themeName, const QString &iconName, QSet<QString> &visitedThemes, QVector<GnomeIconEntry> &entries);
+    QVector<GnomeIconEntry> lookupUnthemed(const QString &iconName) const;
+
+    QString m_themeName;
+    QStringList m_searchPaths;
+    std::map<QString, std::unique_ptr<GnomeIconTheme>> m_themes;
+    int m_themeKey = -1;
+};
+
+Q_GLOBAL_STATIC(GnomeIconLoader, iconLoader)
+
+static QString suffixForFlags(quint16 flags)
+{
+    if (flags & GtkIconCache::HasPngSuffix) {
+        return QStringLiteral(".png");
+    } else if (flags & GtkIconCache::HasSvgSuffix) {
+        return QStringLiteral(".svg");
+    } else if (flags & GtkIconCache::HasXpmSuffix) {
+        return QStringLiteral(".xpm");
+    }
+
+    return QString();
+}
+
+GnomeIconTheme::GnomeIconTheme(const QString &name, const QStringList &searchPaths)
+{
+    QString indexPath;
+    for (const QString &searchPath : searchPaths) {
+        const QString themePath = searchPath + QLatin1Char('/') + name;
+        if (!QFileInfo(themePath).isDir()) {
+            continue;
+        }
+
+        if (indexPath.isEmpty() && QFileInfo::exists(themePath + QStringLiteral("/index.theme"))) {
+            indexPath = themePath + QStringLiteral("/index.theme");
+        }
+
+        ContentDirectory content;
+        content.path = themePath;
+        m_contentDirectories.push_back(std::move(content));
+    }
+
+    if (indexPath.isEmpty()) {
+        m_contentDirectories.clear();
+        return;
+    }
+
+    QSettings index(indexPath, QSettings::IniFormat);
+    m_parents = index.value(QStringLiteral("Icon Theme/Inherits")).toStringList();
+    QStringList directories = index.value(QStringLiteral("Icon Theme/Directories")).toStringList();
+    directories << index.value(QStringLiteral("Icon Theme/ScaledDirectories")).toStringList();
+    directories.removeDuplicates();
+
+    QHash<QString, int> directoryIndexes;
+    for (const QString &path : qAsConst(directories)) {
+        index.beginGroup(path);
+
+        GnomeIconDirectory directory;
+        directory.path = path;
+        directory.size = index.value(QStringLiteral("Size")).toInt();
+        directory.scale = qMax(1, index.value(QStringLiteral("Scale"), 1).toInt());
+        directory.minSize = index.value(QStringLiteral("MinSize"), directory.size).toInt();
+        directory.maxSize = index.value(QStringLiteral("MaxSize"), directory.size).toInt();
+        directory.threshold = index.value(QStringLiteral("Threshold"), 2).toInt();
+
+        const QString type = index.value(QStringLiteral("Type")).toString();
+        if (type == QLatin1String("Fixed")) {
+            directory.type = GnomeIconDirectory::Fixed;
+        } else if (type == QLatin1String("Scalable")) {
+            directory.type = GnomeIconDirectory::Scalable;
+        }
+
+        index.endGroup();
+
+        if (directory.size > 0) {
+            directoryIndexes.insert(path, m_directories.count());
+            m_directories << directory;
+        }
+    }
+
+    for (ContentDirectory &content : m_contentDirectories) {
+        content.cache.reset(new GtkIconCache(content.path));
+        if (content.cache->isValid()) {
+            const QStringList cacheDirectories = content.cache->directories();
+            for (const QString &cacheDirectory : cacheDirectories) {
+                content.cacheDirectories << directoryIndexes.value(cacheDirectory, -1);
+            }
+        } else {
+            content.cache.reset();
+            scanIcons(content);
+        }
+    }
+}
+
+void GnomeIconTheme::scanIcons(ContentDirectory &content) const
+{
+    const QStringList nameFilters = {QStringLiteral("*.png"), QStringLiteral("*.svg"), QStringLiteral("*.xpm")};
+
+    for (int i = 0; i < m_directories.count(); i++) {
+        const QDir directory(content.path + QLatin1Char('/') + m_directories[i].path);
+        const QStringList files = directory.entryList(nameFilters, QDir::Files);
+        for (const QString &file : files) {
+            const int dot = file.lastIndexOf(QLatin1Char('.'));
+            const QStringView suffix = QStringView(file).mid(dot + 1);
+
+            quint16 flag = GtkIconCache::HasXpmSuffix;
+            if (suffix == QLatin1String("png")) {
+                flag = GtkIconCache::HasPngSuffix;
+            } else if (suffix == QLatin1String("svg")) {
+                flag = GtkIconCache::HasSvgSuffix;
+            }
+
+            QVector<GtkIconCache::Image> &images = content.scannedIcons[file.left(dot)];
+            if (!images.isEmpty() && images.last().directory == i) {
+                images.last().flags |= flag;
+            } else {
+                images << GtkIconCache::Image{quint16(i), flag};
+            }
+        }
+    }
+}
+
+QVector<GnomeIconEntry> GnomeIconTheme::lookup(const QString &iconName) const
+{
+    QVector<GnomeIconEntry> entries;
+
+    for (const ContentDirectory &content : m_contentDirectories) {
+        const QVector<GtkIconCache::Image> images = content.cache ? content.cache->lookup(iconName) : content.scannedIcons.value(iconName);
+        for (const GtkIconCache::Image &image : images) {
+            const int directoryIndex = content.cache ? content.cacheDirectories.value(image.directory, -1) : image.directory;
+            const QString suffix = suffixForFlags(image.flags);
+            if (directoryIndex < 0 || suffix.isEmpty()) {
+                continue;
+            }
+
+            GnomeIconEntry entry;
+            entry.directory = m_directories[directoryIndex];
+            entry.filePath = content.path + QLatin1Char('/') + entry.directory.path + QLatin1Char('/') + iconName + suffix;
+            entries << entry;
+        }
+    }
+
+    return entries;
+}
+
+int GnomeIconLoader::themeKey()
+{
+    const int themeKey = QIconLoader::instance()->themeKey();
+    if (themeKey != m_themeKey) {
+        m_themeKey = themeKey;
+        m_themeName = QIcon::themeName();
+        m_searchPaths = QIcon::themeSearchPaths();
+        m_themes.clear();
+    }
+
+    return m_themeKey;
+}
+
+const GnomeIconTheme *GnomeIconLoader::theme(const QString &name)
+{
+    auto it = m_themes.find(name);
+    if (it == m_themes.end()) {
+        it = m_themes.emplace(name, std::unique_ptr<GnomeIconTheme>(new GnomeIconTheme(name, m_searchPaths))).first;
+    }
+
+    return it->second->isValid() ? it->second.get() : nullptr;
+}
+
+bool GnomeIconLoader::lookupInTheme(const QString &themeName, const QString &iconName, QSet<QString> &visitedThemes, QVector<GnomeIconEntry> &entries)
+{
+    if (themeName.isEmpty() || visitedThemes.contains(themeName)) {
+        return false;
+    }
+    visitedThemes.insert(themeName);
+
+    const GnomeIconTheme *iconTheme = theme(themeName);
+    if (!iconTheme) {
+        return false;
+    }
+
+    entries = iconTheme->lookup(iconName);
+    if (!entries.isEmpty()) {
+        return true;
+    }
+
+    const QStringList parents = iconTheme->parents();
+    for (const QString &parent : parents) {
+        if (lookupInTheme(parent, iconName, visitedThemes, entries)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+QVector<GnomeIconEntry> GnomeIconLoader::lookup(const QString &iconName)
+{
+    QString name = iconName;
+    while (!name.isEmpty()) {
+        QSet<QString> visitedThemes;
+        QVector<GnomeIconEntry> entries;
+        if (lookupInTheme(m_themeName, name, visitedThemes, entries) || lookupInTheme(QIcon::fallbackThemeName(), name, visitedThemes, entries)
+            || lookupInTheme(QStringLiteral("hicolor"), name, visitedThemes, entries)) {
+            return entries;
+        }
+
+        // Fall back to more generic icons, e.g. "document-save-as" to "document-save"
+        const int dash = name.lastIndexOf(QLatin1Char('-'));
+        if (dash < 0) {
+            break;
+        }
+        name.truncate(dash);
+    }
+
+    return lookupUnthemed(iconName);
+}
+
+QVector<GnomeIconEntry> GnomeIconLoader::lookupUnthemed(const QString &iconName) const
+{
+    QVector<GnomeIconEntry> entries;
+
+    // There is no cache for these, but they are only searched for icons missing in all themes
+    const QStringList searchPaths = QIcon::fallbackSearchPaths();
+    for (const QString &searchPath : searchPaths) {
+        for (const QString &suffix : {QStringLiteral(".png"), QStringLiteral(".svg"), QStringLiteral(".xpm")}) {
+            const QString filePath = searchPath + QLatin1Char('/') + iconName + suffix;
+            if (QFileInfo::exists(filePath)) {
+                GnomeIconEntry entry;
+                entry.filePath = filePath;
+                entry.directory.path = searchPath;
+                entry.directory.type = GnomeIconDirectory::Scalable;
+                entry.directory.size = UNTHEMED_ICON_MAX_SIZE;
+                entry.directory.minSize = 1;
+                entry.directory.maxSize = UNTHEMED_ICON_MAX_SIZE;
+                entries << entry;
+                return entries;
+            }
+        }
+    }
+
+    return entries;
+}
+
+// Icon directory matching, as described by the icon theme specification
+static bool directoryMatchesSize(const GnomeIconDirectory &directory, int size, int scale)
+{
+    if (directory.scale != scale) {
+        return false;
+    }
+
+    switch (directory.type) {
+    case GnomeIconDirectory::Fixed:
+        return directory.size == size;
+    case GnomeIconDirectory::Scalable:
+        return directory.minSize <= size && size <= directory.maxSize;
+    case GnomeIconDirectory::Threshold:
+        return directory.size - directory.threshold <= size && size <= directory.size + directory.threshold;
+    }
+
+    return false;
+}
+
+static int directorySizeDistance(const GnomeIconDirectory &directory, int size, int scale)
+{
+    const int scaledSize = size * scale;
+
+    int minSize = directory.size;
+    int maxSize = directory.size;
+    if (directory.type == GnomeIconDirectory::Scalable) {
+        minSize = directory.minSize;
+        maxSize = directory.maxSize;
+    } else if (directory.type == GnomeIconDirectory::Threshold) {
+        minSize = directory.size - directory.threshold;
+        maxSize = directory.size + directory.threshold;
+    }
+
+    if (scaledSize < minSize * directory.scale) {
+        return minSize * directory.scale - scaledSize;
+    } else if (scaledSize > maxSize * directory.scale) {
+        return scaledSize - maxSize * directory.scale;
+    }
+
+    return 0;
+}
+
+GnomeIconEngine::GnomeIconEngine(const QString &iconName)
+    : m_iconName(iconName)
+{
+}
+
+GnomeIconEngine::~GnomeIconEngine()
+{
+}
+
+void GnomeIconEngine::ensureLoaded()
+{
+    const int themeKey = iconLoader->themeKey();
+    if (themeKey == m_themeKey) {
+        return;
+    }
+
+    m_themeKey = themeKey;
+    m_entries = iconLoader->lookup(m_iconName);
+}
+
+const GnomeIconEntry *GnomeIconEngine::entryForSize(int size, int scale) const
+{
+    for (const GnomeIconEntry &entry : m_entries) {
+        if (directoryMatchesSize(entry.directory, size, scale)) {
+            return &entry;
+        }
+    }
+
+    const GnomeIconEntry *closestEntry = nullptr;
+    int closestDistance = INT_MAX;
+    for (const GnomeIconEntry &entry : m_entries) {
+        const int distance = directorySizeDistance(entry.directory, size, scale);
+        if (distance < closestDistance) {
+            closestDistance = distance;
+            closestEntry = &entry;
+        }
+    }
+
+    return closestEntry;
+}
+
+QList<QSize> GnomeIconEngine::entrySizes()
+{
+    ensureLoaded();
+
+    QList<QSize> sizes;
+    for (const GnomeIconEntry &entry : qAsConst(m_entries)) {
+        const QSize size(entry.directory.size, entry.directory.size);
+        if (!sizes.contains(size)) {
+            sizes << size;
+        }
+    }
+
+    return sizes;
+}
+
+QPixmap GnomeIconEngine::entryPixmap(const QSize &size, QIcon::Mode mode, qreal scale)
+{
+    ensureLoaded();
+
+    // Size is in device pixels, the entry is picked for the size in logical pixels
+    const int extent = qMin(size.width(), size.height());
+    const int integerScale = qMax(1, qCeil(scale));
+    const GnomeIconEntry *entry = entryForSize(extent / integerScale, integerScale);
+    if (!entry || extent <= 0) {
+        return QPixmap();
+    }
+
+    const QString key = QStringLiteral("qgnomeplatform_icon_%1_%2_%3_%4")
+                            .arg(entry->filePath)
+                            .arg(extent)
+                            .arg(int(mode))
+                            .arg(QGuiApplication::palette().cacheKey());
+
+    QPixmap pixmap;
+    if (QPixmapCache::find(key, &pixmap)) {
+        return pixmap;
+    }
+
+    QImageReader reader(entry->filePath);
+    QSize imageSize = reader.size();
+    // Vector icons are rendered at the requested size, bitmaps are only scaled down
+    if (!imageSize.isValid() || entry->filePath.endsWith(QLatin1String(".svg"))) {
+        imageSize = QSize(extent, extent);
+    } else if (imageSize.width() > extent || imageSize.height() > extent) {
+        imageSize.scale(extent, extent, Qt::KeepAspectRatio);
+    }
+    reader.setScaledSize(imageSize);
+
+    pixmap = QPixmap::fromImage(reader.read());
+    if (!pixmap.isNull() && mode != QIcon::Normal) {
+        pixmap = QGuiApplicationPrivate::instance()->applyQIconStyleHelper(mode, pixmap);
+    }
+
+    QPixmapCache::insert(key, pixmap);
+    return pixmap;
+}
+
+void GnomeIconEngine::paint(QPainter *painter, const QRect &rect, QIcon::Mode mode, QIcon::State state)
+{
+    Q_UNUSED(state)
+
+    const qreal devicePixelRatio = painter->device()->devicePixelRatioF();
+    painter->drawPixmap(rect, entryPixmap(rect.size() * devicePixelRatio, mode, devicePixelRatio));
+}
+
+QSize GnomeIconEngine::actualSize(const QSize &size, QIcon::Mode mode, QIcon::State state)
+{
+    Q_UNUSED(mode)
+    Q_UNUSED(state)
+
+    ensureLoaded();
+
+    const int extent = qMin(size.width(), size.height());
+    const GnomeIconEntry *entry = entryForSize(extent, 1);
+    if (!entry) {
+        return QSize();
+    }
+
+    if (entry->directory.type == GnomeIconDirectory::Scalable) {
+        return QSize(extent, extent);
+    }
+
+    const int actualExtent = qMin(entry->directory.size, extent);
+    return QSize(actualExtent, actualExtent);
+}
+
+QPixmap GnomeIconEngine::pixmap(const QSize &size, QIcon::Mode mode, QIcon::State state)
+{
+    Q_UNUSED(state)
+
+    return entryPixmap(size, mode, 1.0);
+}
+
+QString GnomeIconEngine::key() const
+{
+    // Same key and stream layout as Qt's own theme icon engine, so QIcon reads serialized
+    // icons back as themed icons with the same name
+    return QStringLiteral("QIconLoaderEngine");
+}
+
+bool GnomeIconEngine::read(QDataStream &in)
+{
+    in >> m_iconName;
+    m_themeKey = -1;
+    m_entries.clear();
+    return true;
+}
+
+bool GnomeIconEngine::write(QDataStream &out) const
+{
+    out << m_iconName;
+    return true;
+}
+
+QIconEngine *GnomeIconEngine::clone() const
+{
+    return new GnomeIconEngine(m_iconName);
+}
+
+#if QT_VERSION >= 0x060000
+QList<QSize> GnomeIconEngine::availableSizes(QIcon::Mode mode, QIcon::State state)
+{
+    Q_UNUSED(mode)
+    Q_UNUSED(state)
+
+    return entrySizes();
+}
+
+QString GnomeIconEngine::iconName()
+{
+    ensureLoaded();
+    return m_entries.isEmpty() ? QString() : m_iconName;
+}
+
+bool GnomeIconEngine::isNull()
+{
+    ensureLoaded();
+    return m_entries.isEmpty();
+}
+
+QPixmap GnomeIconEngine::scaledPixmap(const QSize &size, QIcon::Mode mode, QIcon::State state, qreal scale)
+{
+    Q_UNUSED(state)
+
+    return entryPixmap(size, mode, scale);
+}
+#else
+void GnomeIconEngine::virtual_hook(int id, void *data)
+{
+    ensureLoaded();
+
+    switch (id) {
+    case QIconEngine::AvailableSizesHook: {
+        QIconEngine::AvailableSizesArgument &argument = *reinterpret_cast<QIconEngine::AvailableSizesArgument *>(data);
+        argument.sizes = entrySizes();
+        break;
+    }
+    case QIconEngine::IconNameHook:
+        *reinterpret_cast<QString *>(data) = m_entries.isEmpty() ? QString() : m_iconName;
+        break;
+    case QIconEngine::IsNullHook:
+        *reinterpret_cast<bool *>(data) = m_entries.isEmpty();
+        break;
+    case QIconEngine::ScaledPixmapHook: {
+        QIconEngine::ScaledPixmapArgument &argument = *reinterpret_cast<QIconEngine::ScaledPixmapArgument *>(data);
+        argument.pixmap = entryPixmap(argument.size, argument.mode, argument.scale);
+        break;
+    }
+    default:
+        QIconEngine::virtual_hook(id, data);
+    }
+}
+#endif
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2026 The QGnomePlatform contributors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#ifndef GNOME_ICON_ENGINE_H
+#define GNOME_ICON_ENGINE_H
+
+#include <QIconEngine>
+#include <QVector>
+
+// Subdirectory of an icon theme, as described in its index.theme
+struct GnomeIconDirectory {
+    enum Type {
+        Fixed,
+        Scalable,
+        Threshold,
+    };
+
+    QString path;
+    Type type = Threshold;
+    int size = 0;
+    int scale = 1;
+    int minSize = 0;
+    int maxSize = 0;
+    int threshold = 2;
+};
+
+struct GnomeIconEntry {
+    QString filePath;
+    GnomeIconDirectory directory;
+};
+
+// Icon engine for themed icons, which resolves icons using icon-theme.cache files
+// of the themes instead of looking for files in all theme directories
+class GnomeIconEngine : public QIconEngine
+{
+public:
+    explicit GnomeIconEngine(const QString &iconName);
+    ~GnomeIconEngine() override;
+
+    void paint(QPainter *painter, const QRect &rect, QIcon::Mode mode, QIcon::State state) override;
+    QSize actualSize(const QSize &size, QIcon::Mode mode, QIcon::State state) override;
+    QPixmap pixmap(const QSize &size, QIcon::Mode mode, QIcon::State state) override;
+    QString key() const override;
+    bool read(QDataStream &in) override;
+    bool write(QDataStream &out) const override;
+    QIconEngine *clone() const override;
+
+#if QT_VERSION >= 0x060000
+    QList<QSize> availableSizes(QIcon::Mode mode = QIcon::Normal, QIcon::State state = QIcon::Off) override;
+    QString iconName() override;
+    bool isNull() override;
+    QPixmap scaledPixmap(const QSize &size, QIcon::Mode mode, QIcon::State state, qreal scale) override;
+#else
+    void virtual_hook(int id, void *data) override;
+#endif
+
+private:
+    void ensureLoaded();
+    const GnomeIconEntry *entryForSize(int size, int scale) const;
+    QList<QSize> entrySizes();
+    QPixmap entryPixmap(const QSize &size, QIcon::Mode mode, qreal scale);
+
+    QString m_iconName;
+    // Icon loader key the entries were looked up with
+    int m_themeKey = -1;
+    QVector<GnomeIconEntry> m_entries;
+};
+
+#endif // GNOME_ICON_ENGINE_H
@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) 2026 The QGnomePlatform contributors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#include "gtkiconcache.h"
+
+#include <QFileInfo>
+#include <QtEndian>
+
+#include <cstring>
+
+// Layout of icon-theme.cache, all numbers are big endian:
+//   header:         CARD16 major version (1), CARD16 minor version (0), CARD32 hash offset, CARD32 directory list offset
+//   directory list: CARD32 count, CARD32 string offset per directory
+//   hash:           CARD32 bucket count, CARD32 icon offset per bucket
+//   icon:           CARD32 chain offset, CARD32 name offset, CARD32 image list offset
+//   image list:     CARD32 count, per image CARD16 directory index, CARD16 flags, CARD32 image data offset
+#define CACHE_HEADER_SIZE 12
+#define CACHE_NO_OFFSET 0xffffffff
+
+// Same hash function as GTK uses to build the cache
+static quint32 iconNameHash(const char *name)
+{
+    const signed char *p = reinterpret_cast<const signed char *>(name);
+    quint32 hash = *p;
+    if (hash) {
+        for (p += 1; *p != '\0'; p++) {
+            hash = (hash << 5) - hash + *p;
+        }
+    }
+    return hash;
+}
+
+GtkIconCache::GtkIconCache(const QString &themeDir)
+    : m_file(themeDir + QStringLiteral("/icon-theme.cache"))
+{
+    // GTK ignores caches older than the theme directory, icons might have been added since
+    const QFileInfo cacheInfo(m_file.fileName());
+    if (!cacheInfo.isFile() || cacheInfo.lastModified() < QFileInfo(themeDir).lastModified()) {
+        return;
+    }
+
+    if (!m_file.open(QIODevice::ReadOnly) || m_file.size() < CACHE_HEADER_SIZE || m_file.size() > CACHE_NO_OFFSET) {
+        return;
+    }
+
+    m_data = m_file.map(0, m_file.size());
+    m_size = m_file.size();
+    if (!m_data) {
+        return;
+    }
+
+    quint16 majorVersion = 0;
+    quint16 minorVersion = 0;
+    quint32 directoryListOffset = 0;
+    quint32 directoryCount = 0;
+    read16(0, &majorVersion);
+    read16(2, &minorVersion);
+    if (majorVersion != 1 || minorVersion != 0 || !read32(4, &m_hashOffset) || !read32(8, &directoryListOffset)
+        || !read32(directoryListOffset, &directoryCount) || directoryCount > (m_size - directoryListOffset) / 4) {
+        m_data = nullptr;
+        return;
+    }
+
+    for (quint32 i = 0; i < directoryCount; i++) {
+        quint32 offset = 0;
+        read32(directoryListOffset + 4 + i * 4, &offset);
+        const char *directory = stringAt(offset);
+        if (!directory) {
+            m_data = nullptr;
+            m_directories.clear();
+            return;
+        }
+        m_directories << QFile::decodeName(directory);
+    }
+}
+
+QVector<GtkIconCache::Image> GtkIconCache::lookup(const QString &iconName) const
+{
+    QVector<Image> images;
+    if (!m_data || iconName.isEmpty()) {
+        return images;
+    }
+
+    const QByteArray name = iconName.toUtf8();
+    quint32 bucketCount = 0;
+    if (!read32(m_hashOffset, &bucketCount) || bucketCount == 0) {
+        return images;
+    }
+
+    quint32 iconOffset = CACHE_NO_OFFSET;
+    read32(m_hashOffset + 4 + (iconNameHash(name.constData()) % bucketCount) * 4, &iconOffset);
+
+    // Chain length is bounded, so that a corrupted cache can't make us loop forever
+    for (quint32 chainLength = 0; iconOffset != CACHE_NO_OFFSET && chainLength < m_size / 12; chainLength++) {
+        quint32 chainOffset = CACHE_NO_OFFSET;
+        quint32 nameOffset = 0;
+        quint32 imageListOffset = 0;
+        if (!read32(iconOffset, &chainOffset) || !read32(iconOffset + 4, &nameOffset) || !read32(iconOffset + 8, &imageListOffset)) {
+            break;
+        }
+
+        const char *cachedName = stringAt(nameOffset);
+        if (cachedName && name == cachedName) {
+            quint32 imageCount = 0;
+            if (!read32(imageListOffset, &imageCount) || imageCount > (m_size - imageListOffset - 4) / 8) {
+                break;
+            }
+
+            images.reserve(imageCount);
+            for (quint32 i = 0; i < imageCount; i++) {
+                Image image;
+                read16(imageListOffset + 4 + i * 8, &image.directory);
+                read16(imageListOffset + 6 + i * 8, &image.flags);
+                if (image.directory < m_directories.count()) {
+                    images << image;
+                }
+            }
+            break;
+        }
+
+        iconOffset = chainOffset;
+    }
+
+    return images;
+}
+
+bool GtkIconCache::read16(quint32 offset, quint16 *value) const
+{
+    if (offset > m_size - 2) {
+        return false;
+    }
+
+    *value = qFromBigEndian<quint16>(m_data + offset);
+    return true;
+}
+
+bool GtkIconCache::read32(quint32 offset, quint32 *value) const
+{
+    if (offset > m_size - 4) {
+        return false;
+    }
+
+    *value = qFromBigEndian<quint32>(m_data + offset);
+    return true;
+}
+
+const char *GtkIconCache::stringAt(quint32 offset) const
+{
+    if (offset >= m_size) {
+        return nullptr;
+    }
+
+    const char *string = reinterpret_cast<const char *>(m_data + offset);
+    // Strings must be terminated within the mapped file
+    if (!std::memchr(string, '\0', m_size - offset)) {
+        return nullptr;
+    }
+
+    return string;
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2026 The QGnomePlatform contributors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#ifndef GTK_ICON_CACHE_H
+#define GTK_ICON_CACHE_H
+
+#include <QFile>
+#include <QStringList>
+#include <QVector>
+
+// Reader of the icon-theme.cache file generated by gtk-update-icon-cache,
+// the file is mapped into memory and looked up without touching the disk
+class GtkIconCache
+{
+public:
+    enum ImageFlag {
+        HasXpmSuffix = 1,
+        HasSvgSuffix = 2,
+        HasPngSuffix = 4,
+        HasIconFile = 8,
+    };
+
+    struct Image {
+        // Index into directories()
+        quint16 directory;
+        quint16 flags;
+    };
+
+    // Uses icon-theme.cache from the given theme directory, unless missing or out of date
+    explicit GtkIconCache(const QString &themeDir);
+
+    bool isValid() const
+    {
+        return m_data;
+    }
+
+    // Directories of the theme as stored in the cache, relative to the theme directory
+    QStringList directories() const
+    {
+        return m_directories;
+    }
+
+    QVector<Image> lookup(const QString &iconName) const;
+
+private:
+    Q_DISABLE_COPY(GtkIconCache)
+
+    bool read16(quint32 offset, quint16 *value) const;
+    bool read32(quint32 offset, quint32 *value) const;
+    const char *stringAt(quint32 offset) const;
+
+    QFile m_file;
+    const uchar *m_data = nullptr;
+    quint32 m_size = 0;
+    quint32 m_hashOffset = 0;
+    QStringList m_directories;
+};
+
+#endif // GTK_ICON_CACHE_H
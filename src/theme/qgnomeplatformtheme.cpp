@@ -19,6 +19,8 @@
  */
 
 #include "qgnomeplatformtheme.h"
+#include "gnomefileiconprovider.h"
+#include "gnomeiconengine.h"
 #include "gnomesettings.h"
 #include "qgtk3dialoghelpers.h"
 #include "qxdgdesktopportalfiledialog_p.h"
@@ -28,6 +30,8 @@
 #include <QLoggingCategory>
 #include <QQuickStyle>
 #include <QStyleFactory>
+#include <QThread>
+#include <QTimer>
 
 #undef signals
 #include <gtk-3.0/gtk/gtk.h>
@@ -63,6 +67,18 @@ void gtkMessageHandler(const gchar *log_domain, GLogLevelFlags log_level, const
 
 QGnomePlatformTheme::QGnomePlatformTheme()
 {
+    // The application object is still being constructed when the platform theme gets created,
+    // whether it's a widget application is known only once it's done
+    QMetaObject::invokeMethod(
+        &m_interestContext,
+        [this]() {
+            const GnomeSettings::SettingsInterest interest =
+                qobject_cast<QApplication *>(QCoreApplication::instance()) ? GnomeSettings::ApplicationInterest : GnomeSettings::QuickInterest;
+            m_interests = interest;
+            GnomeSettings::getInstance().registerInterest(interest);
+        },
+        Qt::QueuedConnection);
+
     if (QGuiApplication::platformName() != QStringLiteral("xcb")) {
         if (!qEnvironmentVariableIsSet("QT_WAYLAND_DECORATION")) {
             qputenv("QT_WAYLAND_DECORATION", "gnome");
@@ -87,6 +103,11 @@ QGnomePlatformTheme::QGnomePlatformTheme()
     g_type_ensure(PANGO_TYPE_FONT_FAMILY);
     g_type_ensure(PANGO_TYPE_FONT_FACE);
 
+    // Optionally load fonts for the font chooser once the application is idle
+    if (qEnvironmentVariableIntValue("QGNOMEPLATFORM_PREWARM_FONTS")) {
+        QTimer::singleShot(0, &QGtk3FontDialogHelper::warmUpFontMap);
+    }
+
 #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
     // Load QGnomeTheme
     m_platformTheme = QGenericUnixTheme::createUnixTheme(QLatin1String("gnome"));
@@ -117,6 +138,11 @@ QGnomePlatformTheme::QGnomePlatformTheme()
 
 QGnomePlatformTheme::~QGnomePlatformTheme()
 {
+    if (m_interests & GnomeSettings::ApplicationInterest) {
+        GnomeSettings::getInstance().unregisterInterest(GnomeSettings::ApplicationInterest);
+    } else if (m_interests & GnomeSettings::QuickInterest) {
+        GnomeSettings::getInstance().unregisterInterest(GnomeSettings::QuickInterest);
+    }
 }
 
 QVariant QGnomePlatformTheme::themeHint(QPlatformTheme::ThemeHint hintType) const
@@ -136,9 +162,7 @@ const QFont *QGnomePlatformTheme::font(Font type) const
 
 const QPalette *QGnomePlatformTheme::palette(Palette type) const
 {
-    Q_UNUSED(type)
-
-    return GnomeSettings::getInstance().palette();
+    return GnomeSettings::getInstance().palette(type);
 }
 
 bool QGnomePlatformTheme::usePlatformNativeDialog(QPlatformTheme::DialogType type) const
@@ -174,6 +198,23 @@ QPlatformDialogHelper *QGnomePlatformTheme::createPlatformDialogHelper(QPlatform
     }
 }
 
+QIconEngine *QGnomePlatformTheme::createIconEngine(const QString &iconName) const
+{
+    return new GnomeIconEngine(iconName);
+}
+
+QIcon QGnomePlatformTheme::fileIcon(const QFileInfo &fileInfo, QPlatformTheme::IconOptions iconOptions) const
+{
+    Q_UNUSED(iconOptions)
+
+    // Qt 5 file icon providers ask from the thread gathering file information, which may wait
+    // for the disk, the content type is resolved right there. The icon itself is looked up
+    // once it's used from the GUI thread
+    const bool guiThread = QThread::currentThread() == QCoreApplication::instance()->thread();
+    const QString contentType = guiThread ? QString() : GnomeFileIconProvider::getInstance().resolvedContentType(fileInfo);
+    return QIcon(new GnomeFileIconEngine(fileInfo, contentType));
+}
+
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
 #ifndef QT_NO_SYSTEMTRAYICON
 static bool isDBusTrayAvailable()
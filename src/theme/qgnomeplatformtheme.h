@@ -20,7 +20,10 @@
 #ifndef QGNOME_PLATFORM_THEME_H
 #define QGNOME_PLATFORM_THEME_H
 
+#include "gnomesettings.h"
+
 #include <QFont>
+#include <QObject>
 #include <QPalette>
 #include <QVariant>
 #include <qpa/qplatformtheme.h>
@@ -36,6 +39,8 @@ public:
     const QPalette *palette(Palette type = SystemPalette) const Q_DECL_OVERRIDE;
     bool usePlatformNativeDialog(DialogType type) const Q_DECL_OVERRIDE;
     QPlatformDialogHelper *createPlatformDialogHelper(DialogType type) const Q_DECL_OVERRIDE;
+    QIconEngine *createIconEngine(const QString &iconName) const Q_DECL_OVERRIDE;
+    QIcon fileIcon(const QFileInfo &fileInfo, QPlatformTheme::IconOptions iconOptions = {}) const Q_DECL_OVERRIDE;
 #ifndef QT_NO_SYSTEMTRAYICON
     QPlatformSystemTrayIcon *createPlatformSystemTrayIcon() const Q_DECL_OVERRIDE;
 #endif
@@ -46,6 +51,9 @@ public:
 #endif
 
 private:
+    // Receives the interest registration, which gets dropped with the theme if it didn't happen yet
+    QObject m_interestContext;
+    GnomeSettings::SettingsInterests m_interests;
 #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
     // Used to load Qt's internall platform theme to get access to
     // non-public stuff, like QDBusTrayIcon
@@ -38,12 +38,15 @@
 ****************************************************************************/
 
 #include "qgtk3dialoghelpers.h"
+#include "utils.h"
 
 #include <qcolor.h>
+#include <qcoreapplication.h>
 #include <qdebug.h>
 #include <qeventloop.h>
 #include <qfileinfo.h>
 #include <qfont.h>
+#include <qthread.h>
 #include <qwindow.h>
 
 #include <private/qguiapplication_p.h>
@@ -56,6 +59,9 @@
 #endif
 #include <gtk/gtk.h>
 #include <pango/pango.h>
+#include <pango/pangocairo.h>
+
+#include <atomic>
 
 QT_BEGIN_NAMESPACE
 
@@ -534,33 +540,6 @@ void QGtk3FileDialogHelper::setNameFilters(const QStringList &filters)
     }
 }
 
-QGtk3FontDialogHelper::QGtk3FontDialogHelper()
-{
-    d.reset(new QGtk3Dialog(gtk_font_chooser_dialog_new("", 0)));
-    connect(d.data(), SIGNAL(accept()), this, SLOT(onAccepted()));
-    connect(d.data(), SIGNAL(reject()), this, SIGNAL(reject()));
-}
-
-QGtk3FontDialogHelper::~QGtk3FontDialogHelper()
-{
-}
-
-bool QGtk3FontDialogHelper::show(Qt::WindowFlags flags, Qt::WindowModality modality, QWindow *parent)
-{
-    applyOptions();
-    return d->show(flags, modality, parent);
-}
-
-void QGtk3FontDialogHelper::exec()
-{
-    d->exec();
-}
-
-void QGtk3FontDialogHelper::hide()
-{
-    d->hide();
-}
-
 static QString qt_fontToString(const QFont &font)
 {
     PangoFontDescription *desc = pango_font_description_new();
@@ -602,59 +581,118 @@ static QString qt_fontToString(const QFont &font)
     return name;
 }
 
-static QFont qt_fontFromString(const QString &name)
-{
-    QFont font;
-    PangoFontDescription *desc = pango_font_description_from_string(name.toUtf8());
-    font.setPointSizeF(static_cast<float>(pango_font_description_get_size(desc)) / PANGO_SCALE);
-
-    QString family = QString::fromUtf8(pango_font_description_get_family(desc));
-    if (!family.isEmpty())
-        font.setFamily(family);
-
-    const int weight = pango_font_description_get_weight(desc);
-    if (weight >= PANGO_WEIGHT_HEAVY)
-        font.setWeight(QFont::Black);
-    else if (weight >= PANGO_WEIGHT_ULTRABOLD)
-        font.setWeight(QFont::ExtraBold);
-    else if (weight >= PANGO_WEIGHT_BOLD)
-        font.setWeight(QFont::Bold);
-    else if (weight >= PANGO_WEIGHT_SEMIBOLD)
-        font.setWeight(QFont::DemiBold);
-    else if (weight >= PANGO_WEIGHT_MEDIUM)
-        font.setWeight(QFont::Medium);
-    else if (weight >= PANGO_WEIGHT_NORMAL)
-        font.setWeight(QFont::Normal);
-    else if (weight >= PANGO_WEIGHT_LIGHT)
-        font.setWeight(QFont::Light);
-    else if (weight >= PANGO_WEIGHT_ULTRALIGHT)
-        font.setWeight(QFont::ExtraLight);
-    else
-        font.setWeight(QFont::Thin);
+// Font map loaded in background by warmUpFontMap(), owned by us once set
+static std::atomic<PangoFontMap *> warmFontMap{nullptr};
+static QThread *warmUpThread = nullptr;
 
-    PangoStyle style = pango_font_description_get_style(desc);
-    if (style == PANGO_STYLE_ITALIC)
-        font.setStyle(QFont::StyleItalic);
-    else if (style == PANGO_STYLE_OBLIQUE)
-        font.setStyle(QFont::StyleOblique);
-    else
-        font.setStyle(QFont::StyleNormal);
+// Joins the warm-up thread and drops our font map reference when the application goes away
+static void releaseWarmFontMap()
+{
+    if (warmUpThread) {
+        warmUpThread->wait();
+        delete warmUpThread;
+        warmUpThread = nullptr;
+    }
 
-    pango_font_description_free(desc);
-    return font;
+    if (PangoFontMap *fontMap = warmFontMap.exchange(nullptr)) {
+        g_object_unref(fontMap);
+    }
+}
+
+void QGtk3FontDialogHelper::warmUpFontMap()
+{
+    static bool started = false;
+    if (started) {
+        return;
+    }
+    started = true;
+
+    // Listing families and faces makes fontconfig and pango load everything the chooser
+    // is going to need, fontconfig caches are shared with the font map used by GTK
+    warmUpThread = QThread::create([]() {
+        PangoFontMap *fontMap = pango_cairo_font_map_new();
+
+        PangoFontFamily **families = nullptr;
+        int familyCount = 0;
+        pango_font_map_list_families(fontMap, &families, &familyCount);
+        for (int i = 0; i < familyCount; ++i) {
+            PangoFontFace **faces = nullptr;
+            int faceCount = 0;
+            pango_font_family_list_faces(families[i], &faces, &faceCount);
+            g_free(faces);
+        }
+        g_free(families);
+
+        warmFontMap.store(fontMap);
+    });
+    qAddPostRoutine(releaseWarmFontMap);
+    warmUpThread->start(QThread::LowPriority);
+}
+
+QGtk3FontDialogHelper::QGtk3FontDialogHelper()
+{
+    warmUpFontMap();
+}
+
+QGtk3FontDialogHelper::~QGtk3FontDialogHelper()
+{
+}
+
+QGtk3Dialog *QGtk3FontDialogHelper::dialog()
+{
+    if (!d) {
+        GtkWidget *gtkDialog = gtk_font_chooser_dialog_new("", 0);
+        // Use the pre-loaded fonts if they are ready, otherwise GTK loads them on its own
+        if (PangoFontMap *fontMap = warmFontMap.load()) {
+            gtk_font_chooser_set_font_map(GTK_FONT_CHOOSER(gtkDialog), fontMap);
+        }
+
+        d.reset(new QGtk3Dialog(gtkDialog));
+        connect(d.data(), SIGNAL(accept()), this, SLOT(onAccepted()));
+        connect(d.data(), SIGNAL(reject()), this, SIGNAL(reject()));
+
+        gtk_font_chooser_set_font(GTK_FONT_CHOOSER(gtkDialog), qt_fontToString(m_currentFont).toUtf8());
+    }
+
+    return d.data();
+}
+
+bool QGtk3FontDialogHelper::show(Qt::WindowFlags flags, Qt::WindowModality modality, QWindow *parent)
+{
+    applyOptions();
+    return dialog()->show(flags, modality, parent);
+}
+
+void QGtk3FontDialogHelper::exec()
+{
+    dialog()->exec();
+}
+
+void QGtk3FontDialogHelper::hide()
+{
+    if (d) {
+        d->hide();
+    }
 }
 
 void QGtk3FontDialogHelper::setCurrentFont(const QFont &font)
 {
-    GtkFontChooser *gtkDialog = GTK_FONT_CHOOSER(d->gtkDialog());
-    gtk_font_chooser_set_font(gtkDialog, qt_fontToString(font).toUtf8());
+    m_currentFont = font;
+    if (d) {
+        GtkFontChooser *gtkDialog = GTK_FONT_CHOOSER(d->gtkDialog());
+        gtk_font_chooser_set_font(gtkDialog, qt_fontToString(font).toUtf8());
+    }
 }
 
 QFont QGtk3FontDialogHelper::currentFont() const
 {
+    if (!d) {
+        return m_currentFont;
+    }
+
     GtkFontChooser *gtkDialog = GTK_FONT_CHOOSER(d->gtkDialog());
     gchar *name = gtk_font_chooser_get_font(gtkDialog);
-    QFont font = qt_fontFromString(QString::fromUtf8(name));
+    QFont font = Utils::qt_fontFromString(QString::fromUtf8(name));
     g_free(name);
     return font;
 }
@@ -668,7 +706,7 @@ void QGtk3FontDialogHelper::onAccepted()
 
 void QGtk3FontDialogHelper::applyOptions()
 {
-    GtkDialog *gtkDialog = d->gtkDialog();
+    GtkDialog *gtkDialog = dialog()->gtkDialog();
     const QSharedPointer<QFontDialogOptions> &opts = options();
 
     gtk_window_set_title(GTK_WINDOW(gtkDialog), opts->windowTitle().toUtf8());
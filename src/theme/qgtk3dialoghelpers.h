@@ -45,6 +45,7 @@
 #include <QtCore/qscopedpointer.h>
 #include <QtCore/qstring.h>
 #include <QtCore/qurl.h>
+#include <QtGui/qfont.h>
 #include <qpa/qplatformdialoghelper.h>
 
 typedef struct _GtkWidget GtkWidget;
@@ -138,13 +139,19 @@ public:
     void setCurrentFont(const QFont &font) Q_DECL_OVERRIDE;
     QFont currentFont() const Q_DECL_OVERRIDE;
 
+    // Loads fonts in a background thread, so that the font chooser opens quickly
+    static void warmUpFontMap();
+
 private Q_SLOTS:
     void onAccepted();
 
 private:
     void applyOptions();
+    // GtkFontChooser loads all fonts when created, so it's created only when needed
+    QGtk3Dialog *dialog();
 
     QScopedPointer<QGtk3Dialog> d;
+    QFont m_currentFont;
 };
 
 QT_END_NAMESPACE
@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2026 The QGnomePlatform contributors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#include "alphablur.h"
+
+#include <QImage>
+#include <QPainter>
+#include <QRandomGenerator>
+#include <QTest>
+
+QT_BEGIN_NAMESPACE
+Q_DECL_IMPORT void qt_blurImage(QPainter *p, QImage &blurImage, qreal radius, bool quality, bool alphaOnly, int transposed = 0);
+QT_END_NAMESPACE
+
+// Radius the decoration shadows are blurred with
+#define SHADOW_BLUR_RADIUS 12
+// Size of the benchmarked image, about a shadow tile of a window at scale 2
+#define BENCHMARK_IMAGE_SIZE 256
+
+Q_DECLARE_METATYPE(AlphaBlurPath)
+
+class AlphaBlurTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void exactness_data();
+    void exactness();
+    void benchmark_data();
+    void benchmark();
+};
+
+static QImage randomImage(int width, int height)
+{
+    QImage image(width, height, QImage::Format_Alpha8);
+    QRandomGenerator generator(width * 1000 + height);
+    for (int y = 0; y < height; ++y) {
+        uchar *line = image.scanLine(y);
+        for (int x = 0; x < width; ++x) {
+            line[x] = uchar(generator.bounded(256));
+        }
+    }
+    return image;
+}
+
+// Rounded rectangle with an empty margin around it, as painted for shadows
+static QImage shadowMask()
+{
+    QImage image(BENCHMARK_IMAGE_SIZE, BENCHMARK_IMAGE_SIZE, QImage::Format_Alpha8);
+    image.fill(0);
+
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(Qt::black);
+    painter.drawRoundedRect(image.rect().adjusted(SHADOW_BLUR_RADIUS * 2, SHADOW_BLUR_RADIUS * 2, -SHADOW_BLUR_RADIUS * 2, -SHADOW_BLUR_RADIUS * 2), 8, 8);
+    return image;
+}
+
+void AlphaBlurTest::exactness_data()
+{
+    QTest::addColumn<AlphaBlurPath>("path");
+    QTest::addColumn<int>("width");
+    QTest::addColumn<int>("height");
+    QTest::addColumn<int>("radius");
+
+    const QList<QPair<const char *, AlphaBlurPath>> paths = {{"sse2", Sse2AlphaBlurPath}, {"avx2", Avx2AlphaBlurPath}};
+    for (const auto &path : paths) {
+        // Widths not divisible by the vector size go through the scalar tails as well
+        for (const QSize &size : {QSize(1, 1), QSize(17, 40), QSize(66, 66), QSize(133, 7), QSize(256, 256)}) {
+            for (int radius : {2, SHADOW_BLUR_RADIUS, 40}) {
+                QTest::addRow("%s %dx%d radius %d", path.first, size.width(), size.height(), radius) << path.second << size.width() << size.height() << radius;
+            }
+        }
+    }
+}
+
+void AlphaBlurTest::exactness()
+{
+    QFETCH(AlphaBlurPath, path);
+    QFETCH(int, width);
+    QFETCH(int, height);
+    QFETCH(int, radius);
+
+    if (!alphaBlurPathSupported(path)) {
+        QSKIP("Not supported by this build or CPU");
+    }
+
+    QImage expected = randomImage(width, height);
+    QImage actual = expected.copy();
+
+    blurAlphaImage(expected, radius, ScalarAlphaBlurPath);
+    blurAlphaImage(actual, radius, path);
+
+    // SIMD paths use the same integer arithmetic, results must not differ at all
+    QCOMPARE(actual, expected);
+}
+
+void AlphaBlurTest::benchmark_data()
+{
+    QTest::addColumn<bool>("alphaBlur");
+
+    QTest::newRow("qt_blurImage") << false;
+    QTest::newRow("blurAlphaImage") << true;
+}
+
+void AlphaBlurTest::benchmark()
+{
+    QFETCH(bool, alphaBlur);
+
+    const QImage mask = shadowMask();
+
+    if (alphaBlur) {
+        QBENCHMARK {
+            QImage image = mask.copy();
+            blurAlphaImage(image, SHADOW_BLUR_RADIUS);
+        }
+    } else {
+        // What shadows were painted with before, into an ARGB image
+        const QImage source = mask.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+        QImage target(source.size(), QImage::Format_ARGB32_Premultiplied);
+        QBENCHMARK {
+            QImage image = source.copy();
+            target.fill(Qt::transparent);
+            QPainter painter(&target);
+            qt_blurImage(&painter, image, SHADOW_BLUR_RADIUS, false, false);
+        }
+    }
+}
+
+QTEST_MAIN(AlphaBlurTest)
+
+#include "alphablurtest.moc"
@@ -0,0 +1,219 @@
+/*
+ * Copyright (C) 2026 The QGnomePlatform contributors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ */
+
+#include "utils.h"
+
+#include <QFont>
+#include <QTest>
+
+#undef signals
+#include <pango/pango.h>
+#define signals Q_SIGNALS
+
+// Utils::qt_fontFromString() parses Pango font descriptions on its own, these tests make sure
+// it reads them the same way as pango_font_description_from_string()
+class FontParserTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void parse_data();
+    void parse();
+};
+
+static QStringList fontFamilies(const QFont &font)
+{
+    QStringList families = font.families();
+    if (families.size() < 2) {
+        families = QStringList{font.family()};
+    }
+    return families;
+}
+
+static QFont::Weight fontWeight(int weight)
+{
+    if (weight >= 900) {
+        return QFont::Black;
+    } else if (weight >= 800) {
+        return QFont::ExtraBold;
+    } else if (weight >= 700) {
+        return QFont::Bold;
+    } else if (weight >= 600) {
+        return QFont::DemiBold;
+    } else if (weight >= 500) {
+        return QFont::Medium;
+    } else if (weight >= 400) {
+        return QFont::Normal;
+    } else if (weight >= 300) {
+        return QFont::Light;
+    } else if (weight >= 200) {
+        return QFont::ExtraLight;
+    }
+    return QFont::Thin;
+}
+
+static QFont::Style fontStyle(PangoStyle style)
+{
+    switch (style) {
+    case PANGO_STYLE_OBLIQUE:
+        return QFont::StyleOblique;
+    case PANGO_STYLE_ITALIC:
+        return QFont::StyleItalic;
+    default:
+        return QFont::StyleNormal;
+    }
+}
+
+static QFont::Capitalization fontCapitalization(PangoVariant variant)
+{
+    switch (variant) {
+    case PANGO_VARIANT_SMALL_CAPS:
+#if PANGO_VERSION_CHECK(1, 50, 0)
+    case PANGO_VARIANT_ALL_SMALL_CAPS:
+    case PANGO_VARIANT_PETITE_CAPS:
+    case PANGO_VARIANT_ALL_PETITE_CAPS:
+#endif
+        return QFont::SmallCaps;
+#if PANGO_VERSION_CHECK(1, 50, 0)
+    case PANGO_VARIANT_TITLE_CAPS:
+        return QFont::Capitalize;
+#endif
+    default:
+        return QFont::MixedCase;
+    }
+}
+
+static int fontStretch(PangoStretch stretch)
+{
+    switch (stretch) {
+    case PANGO_STRETCH_ULTRA_CONDENSED:
+        return QFont::UltraCondensed;
+    case PANGO_STRETCH_EXTRA_CONDENSED:
+        return QFont::ExtraCondensed;
+    case PANGO_STRETCH_CONDENSED:
+        return QFont::Condensed;
+    case PANGO_STRETCH_SEMI_CONDENSED:
+        return QFont::SemiCondensed;
+    case PANGO_STRETCH_SEMI_EXPANDED:
+        return QFont::SemiExpanded;
+    case PANGO_STRETCH_EXPANDED:
+        return QFont::Expanded;
+    case PANGO_STRETCH_EXTRA_EXPANDED:
+        return QFont::ExtraExpanded;
+    case PANGO_STRETCH_ULTRA_EXPANDED:
+        return QFont::UltraExpanded;
+    default:
+        // Stretch is left unset
+        return QFont(QLatin1String("Sans"), 10).stretch();
+    }
+}
+
+void FontParserTest::parse_data()
+{
+    QTest::addColumn<QString>("description");
+
+    // Family lists
+    QTest::newRow("family") << QStringLiteral("Cantarell 11");
+    QTest::newRow("family with spaces") << QStringLiteral("DejaVu Sans Mono 10");
+    QTest::newRow("family list") << QStringLiteral("Noto Sans, DejaVu Sans 10");
+    QTest::newRow("family list trailing comma") << QStringLiteral("Noto Sans,DejaVu Sans, 10");
+    QTest::newRow("family only") << QStringLiteral("Monospace");
+    QTest::newRow("no family") << QStringLiteral("Bold 11");
+
+    // Style
+    QTest::newRow("italic") << QStringLiteral("Sans Italic 12");
+    QTest::newRow("oblique") << QStringLiteral("Sans Oblique 12");
+    QTest::newRow("roman") << QStringLiteral("Sans Roman 12");
+    QTest::newRow("bold italic without size") << QStringLiteral("Sans Bold Italic");
+
+    // Variant
+    QTest::newRow("small caps") << QStringLiteral("Sans Small-Caps 10");
+#if PANGO_VERSION_CHECK(1, 50, 0)
+    QTest::newRow("all small caps") << QStringLiteral("Sans All-Small-Caps 10");
+    QTest::newRow("title caps") << QStringLiteral("Sans Title-Caps 10");
+#endif
+
+    // Weight
+    QTest::newRow("thin") << QStringLiteral("Sans Thin 10");
+    QTest::newRow("light") << QStringLiteral("Sans Light 10");
+    QTest::newRow("book") << QStringLiteral("DejaVu Sans Book 11");
+    QTest::newRow("medium") << QStringLiteral("Sans Medium 10");
+    QTest::newRow("semibold") << QStringLiteral("Sans Semi-Bold 10");
+    QTest::newRow("semibold without dash") << QStringLiteral("Sans semibold 10");
+    QTest::newRow("heavy") << QStringLiteral("Sans Heavy 10");
+    QTest::newRow("ultra heavy") << QStringLiteral("Sans Ultra-Heavy 10");
+    QTest::newRow("numeric weight") << QStringLiteral("Sans 650 10");
+    QTest::newRow("normal") << QStringLiteral("Sans Normal 10");
+
+    // Stretch
+    QTest::newRow("condensed") << QStringLiteral("Sans Condensed 9");
+    QTest::newRow("semibold condensed") << QStringLiteral("Sans Semi-Bold Semi-Condensed 9");
+    QTest::newRow("ultra expanded") << QStringLiteral("Sans Ultra-Expanded 9");
+
+    // Gravity is accepted and ignored
+    QTest::newRow("gravity") << QStringLiteral("Sans Not-Rotated 10");
+
+    // Size
+    QTest::newRow("fractional size") << QStringLiteral("Cantarell 10.5");
+    QTest::newRow("pixel size") << QStringLiteral("Sans 14px");
+    QTest::newRow("bold pixel size") << QStringLiteral("Sans Bold 20px");
+    QTest::newRow("variations") << QStringLiteral("Sans 10 @wght=200");
+}
+
+void FontParserTest::parse()
+{
+    QFETCH(QString, description);
+
+    const QFont font = Utils::qt_fontFromString(description);
+
+    PangoFontDescription *pangoDescription = pango_font_description_from_string(description.toUtf8().constData());
+    const char *pangoFamily = pango_font_description_get_family(pangoDescription);
+    const QStringList pangoFamilies = QString::fromUtf8(pangoFamily ? pangoFamily : "Sans").split(QLatin1Char(','));
+    const QFont::Style style = fontStyle(pango_font_description_get_style(pangoDescription));
+    const QFont::Capitalization capitalization = fontCapitalization(pango_font_description_get_variant(pangoDescription));
+    const QFont::Weight weight = fontWeight(pango_font_description_get_weight(pangoDescription));
+    const int stretch = fontStretch(pango_font_description_get_stretch(pangoDescription));
+    const double size = double(pango_font_description_get_size(pangoDescription)) / PANGO_SCALE;
+    const bool sizeInPixels = pango_font_description_get_size_is_absolute(pangoDescription);
+    pango_font_description_free(pangoDescription);
+
+    QStringList families;
+    for (const QString &family : pangoFamilies) {
+        if (!family.trimmed().isEmpty()) {
+            families << family.trimmed();
+        }
+    }
+    QCOMPARE(fontFamilies(font), families);
+
+    QCOMPARE(font.style(), style);
+    QCOMPARE(font.capitalization(), capitalization);
+    QCOMPARE(int(font.weight()), int(weight));
+    QCOMPARE(font.stretch(), stretch);
+
+    if (size <= 0) {
+        QCOMPARE(font.pointSizeF(), 10.0);
+    } else if (sizeInPixels) {
+        QCOMPARE(font.pixelSize(), qRound(size));
+    } else {
+        QCOMPARE(font.pointSizeF(), size);
+    }
+}
+
+QTEST_MAIN(FontParserTest)
+
+#include "fontparsertest.moc"